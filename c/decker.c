@@ -1,4 +1,7 @@
 // Decker
+// one interpreter, shared by the main thread and the audio callback (sfx_pump() runs loop[] handlers), which take turns
+// through interpreter_lock(). its state must be ordinary globals rather than per-thread, so that both threads see one heap.
+#define LIL_LOCAL
 #include "lil.h"
 #include "dom.h"
 
@@ -24,7 +27,7 @@ enum cursor_styles {cursor_default,cursor_point,cursor_ibeam,cursor_drag};
 int uicursor=0, enable_touch=0, set_touch=0;
 int set_tracing=0, tracing=0, toolbar_scroll=0, toolbars_enable=0;
 #define PROFILE_HIST_SZ 200
-int profiler=0, profiler_ix=0, profiler_hist[PROFILE_HIST_SZ]={0};
+int profiler=0, profiler_ix=0, profiler_hist[PROFILE_HIST_SZ]={0}, profiler_gc[PROFILE_HIST_SZ]={0}; // gc: pause per frame, against a 60hz frame
 
 char*TOOL_ICONS=
 	"%%IMG0ABAAwAMABIAEgASABIAEgGTwlKxMqiQKJAIQAggCCAQEBAQEAAAAAAAAAAA//EACgAGAAYABgAFAAz/+H/wAAAAAAA"
@@ -2146,8 +2149,8 @@ void modals(void){
 		ui_dfield((rect){gsize.x+gsize.w+5+lw,b.y+20,b.w-(lw+5+gsize.w),18},sel,&ms.name);
 		ui_dfield((rect){gsize.x+gsize.w+5+lw,b.y+40,b.w-(lw+5+gsize.w),18},sel,&ms.text);
 		if(sel){
-			ms.grid.table->lv[0]->lv[ms.grid.row]=rtext_all(ms.name.table);
-			ms.grid.table->lv[1]->lv[ms.grid.row]=rtext_all(ms.text.table);
+			ms.grid.table->lv[0]->lv[ms.grid.row]=lv_shade(rtext_all(ms.name.table));
+			ms.grid.table->lv[1]->lv[ms.grid.row]=lv_shade(rtext_all(ms.text.table));
 		}
 		pair cr={gsize.x+gsize.w+5+lw,b.y+62}, c={b.x,b.y+b.h-20};
 		char*attr_labels[]={"","Boolean","Number","String","Code","Rich Text",NULL};
@@ -4044,7 +4047,12 @@ void tick(lv*env){
 		for(int z=0;z<r.w-2;z++){
 			int v=0;for(int i=0;i<4;i++)v=MAX(v,profiler_hist[(profiler_ix+(4*z)+i)%PROFILE_HIST_SZ]);
 			draw_invert(pal,(rect){r.x+1+z,r.y+r.h-v,1,v-1});
-		}profiler_hist[profiler_ix]=(r.h-2)*(1.0*used)/FRAME_QUOTA;profiler_ix=(profiler_ix+1)%PROFILE_HIST_SZ;
+		}profiler_hist[profiler_ix]=(r.h-2)*(1.0*used)/FRAME_QUOTA;
+		rect g={r.x,r.y+r.h+2,r.w,r.h};snprintf(t,sizeof(t),"gc %.02fms",tel.last),draw_text(inset(g,2),t,FONT_BODY,1);draw_box(g,0,1);
+		for(int z=0;z<g.w-2;z++){
+			int v=0;for(int i=0;i<4;i++)v=MAX(v,profiler_gc[(profiler_ix+(4*z)+i)%PROFILE_HIST_SZ]);
+			draw_invert(pal,(rect){g.x+1+z,g.y+g.h-v,1,v-1});
+		}profiler_gc[profiler_ix]=MIN(g.h-2,(g.h-2)*tel.last/(1000.0/60));profiler_ix=(profiler_ix+1)%PROFILE_HIST_SZ;
 	}
 	if((uimode==mode_object||(uimode==mode_draw&&!dr.fatbits))&&!ev.hidemenu){
 		rect b={menu.x,1,context.size.x-menu.x-2,1+font_h(FONT_MENU)};
@@ -4079,11 +4087,11 @@ void tick(lv*env){
 	dset(env,lmistr("wid"),wid_track(&wid));
 	dset(env,lmistr("ms"),modal_track(&ms));
 	if(ms_index){lv*r=lml(0);for(int z=0;z<ms_index;z++)ll_add(r,modal_track(&ms_stack[z].ms)),ll_add(r,wid_track(&ms_stack[z].wid));dset(env,lmistr("ms-stack"),r);}
-	EACH(z,PLAYING)PLAYING->lv[z]=audio_slots[z].clip?audio_slots[z].clip:NONE;
+	EACH(z,PLAYING)PLAYING->lv[z]=lv_shade(audio_slots[z].clip?audio_slots[z].clip:NONE);
 	ATTRS->c=0;for(int z=0;z<attrs_count;z++)if(attrs[z].value.table)ll_add(ATTRS,attrs[z].value.table);
 	track(audio_loop.clip)
 	track(orig_loop)
-	lv_collect();
+	lv_collect_slice(GC_SLICE);
 	interpreter_unlock();
 }
 
@@ -4112,6 +4120,12 @@ void resize_window(lv*deck){
 	pair wsize={(size.x+(toolbars_enable?4+2*buff_size(TOOLB).x:0))*minscale,size.y*minscale+(toolbars_enable?4:0)};
 	window_set_size(wsize,size,minscale);
 }
+lv* deck_census(void){ // roots for census[]: each card and module, then the deck and other globals
+	lv*r=lmd(),*cards=ifield(deck,"cards"),*modules=ifield(deck,"modules");
+	EACH(z,cards  )dset(r,l_format(lmistr("card %s"  ),cards  ->kv[z]),cards  ->lv[z]);
+	EACH(z,modules)dset(r,l_format(lmistr("module %s"),modules->kv[z]),modules->lv[z]);
+	EACH(z,env)dset(r,env->kv[z],env->lv[z]);return r;
+}
 void load_deck(lv*d){
 	dirty=0; wid.active=-1; dr=ddr; con_set(NULL);
 	dset(env,lmistr("deck"),deck=d);
@@ -4138,7 +4152,7 @@ int main(int argc,char**argv){
 	}
 	init_interns();
 	if(file){directory_normalize(ms.path,file),directory_parent(ms.path);}else{directory_home(ms.path);}
-	env=lmenv(NULL);init(env);
+	env=lmenv(NULL);init(env);census_roots=deck_census;
 	{lv*i=image_read(lmcstr(TOOL_ICONS ));TOOLS =lml(12);EACH(z,TOOLS )TOOLS ->lv[z]=image_make(buffer_copy(i->b,(rect){0,z*16,16,16}));}
 	{lv*i=image_read(lmcstr(ARROW_ICONS));ARROWS=lml( 8);EACH(z,ARROWS)ARROWS->lv[z]=image_make(buffer_copy(i->b,(rect){0,z*12,12,12}));}
 	dset(env,lmistr("check"    ),CHECK     =image_read(lmistr("%%IMG0AAkABwCAAcGDY8Y2bBw4CBAA")));
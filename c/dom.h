@@ -12,6 +12,7 @@
 #define LOOP_QUOTA     ( 1*4096)
 #define ATTR_QUOTA     ( 1*4096)
 #define FRAME_QUOTA    (10*4096)
+#define GC_SLICE       2000 // microseconds of garbage collection (marking or sweeping) per frame
 #define CLAMP(a,x,b)   ((x)<(a)?(a): (x)>(b)?(b): (x))
 #define itype(name)    int name##_is(lv*x){return x&&lii(x)&&!strcmp(x->a->sv,#name);}
 #define init_field(dst,key,src) {lv*k=lmistr(key),*v=dget(src,k);if(v)iwrite(dst,k,v);}
@@ -23,13 +24,13 @@ typedef struct {
 	int brush, pattern;
 	pair size; rect clip;
 	lv *buffer, *font;
-} cstate; cstate frame;
+} cstate; LIL_LOCAL cstate frame;
 
 itype(image)itype(sound)itype(font)itype(button)itype(field)itype(slider)itype(grid)itype(canvas)itype(deck)itype(card)itype(patterns)itype(module)itype(array)
 itype(prototype)itype(contraption)itype(proxy)
 int widget_is(lv*x){return button_is(x)||field_is(x)||slider_is(x)||grid_is(x)||canvas_is(x)||contraption_is(x)||proxy_is(x);}
 
-int sleep_frames=0, sleep_play=0;
+LIL_LOCAL int sleep_frames=0, sleep_play=0;
 lv* n_sleep(lv*self,lv*z){(void)self;z=l_first(z);if(matchr(z,lmistr("play"))){sleep_play=1;}else{sleep_frames=MAX(1,ln(z));}return z;}
 lv* n_transition(lv*self,lv*z){lv*t=dget(self->b,lmistr("transit"));z=l_first(z);if(lion(z))dset(t,lmcstr(z->sv),z);return t;}
 
@@ -112,12 +113,14 @@ void primitives(lv*env,lv*deck){
 	dset(env,lmistr("sleep"     ),lmnat(n_sleep     ,NULL));
 	dset(env,lmistr("eval"      ),lmnat(n_eval      ,NULL));
 	dset(env,lmistr("random"    ),lmnat(n_random    ,NULL));
+	dset(env,lmistr("memo"      ),lmnat(n_memo      ,NULL));
 	dset(env,lmistr("array"     ),lmnat(n_array     ,NULL));
 	dset(env,lmistr("image"     ),lmnat(n_image     ,NULL));
 	dset(env,lmistr("sound"     ),lmnat(n_sound     ,NULL));
 	dset(env,lmistr("readcsv"   ),lmnat(n_readcsv   ,NULL));
 	dset(env,lmistr("writecsv"  ),lmnat(n_writecsv  ,NULL));
 	dset(env,lmistr("readxml"   ),lmnat(n_readxml   ,NULL));
+	dset(env,lmistr("census"    ),lmnat(n_census    ,NULL));
 	dset(env,lmistr("writexml"  ),lmnat(n_writexml  ,NULL));
 	dset(env,lmistr("alert"     ),lmnat(n_alert     ,NULL));
 	dset(env,lmistr("read"      ),lmnat(n_open      ,NULL));
@@ -224,7 +227,7 @@ lv* event_invokev(lv*target,lv*name,lv*arg,lv*hunk,int nodiscard){
 	blk_cat(b,core);return b;
 }
 lv* event_invoke(lv*target,lv*name,lv*arg,lv*hunk){return event_invokev(target,name,arg,hunk,0);}
-int pending_popstate=0;
+LIL_LOCAL int pending_popstate=0;
 void fire_async(lv*target,lv*name,lv*arg,lv*hunk,int nest){
 	lv*root=lmenv(NULL);primitives(root,parent_deck(target)),constants(root);
 	lv*block=event_invoke(target,name,arg,hunk);
@@ -237,7 +240,7 @@ lv* n_event(lv*self,lv*x){
 }
 void fire_event_async(lv*target,lv*name,lv*arg){fire_async(target,name,l_list(arg),NULL,1);}
 void fire_hunk_async(lv*target,lv*hunk){fire_async(target,NULL,lml(0),hunk,1);}
-int in_attr=0;
+LIL_LOCAL int in_attr=0;
 lv* fire_attr_sync(lv*target,char*prefix,lv*name,lv*arg){
 	if(in_attr>=2)return NONE;in_attr++;cstate bf=frame;
 	lv*root=lmenv(NULL),*deck=ivalue(target,"deck");primitives(root,deck),constants(root);
@@ -366,7 +369,7 @@ lv* buffer_copy(lv*src,rect r){
 pair image_size(lv*x){return buff_size(x->b);}
 lv* image_resize(lv*x,pair size){
 	pair os=image_size(x);char*old=x->b->sv;size.x=MAX(0,size.x),size.y=MAX(0,size.y);if(os.x==size.x&&os.y==size.y)return x;
-	x->b=lmbuff(size);for(int a=0;a<size.y;a++)for(int b=0;b<size.x;b++)x->b->sv[b+a*size.x]=a>=os.y||b>=os.x?0: old[b+a*os.x];return x;
+	x->b=lv_shade(lmbuff(size));for(int a=0;a<size.y;a++)for(int b=0;b<size.x;b++)x->b->sv[b+a*size.x]=a>=os.y||b>=os.x?0: old[b+a*os.x];return x;
 }
 void buffer_dither(lv*r){
 	pair size=buff_size(r); int stride=2*size.x; int m[]={0,1,size.x-2,size.x-1,size.x,stride-1};
@@ -414,9 +417,9 @@ lv* n_image_transform(lv*self,lv*z){
 	z=ls(l_first(z));
 	if     (!strcmp("horiz" ,z->sv))buffer_flip_h(self->b);
 	else if(!strcmp("vert"  ,z->sv))buffer_flip_v(self->b);
-	else if(!strcmp("flip"  ,z->sv))self->b=buffer_transpose(self->b);
-	else if(!strcmp("left"  ,z->sv))buffer_flip_h(self->b),self->b=buffer_transpose(self->b);
-	else if(!strcmp("right" ,z->sv))self->b=buffer_transpose(self->b),buffer_flip_h(self->b);
+	else if(!strcmp("flip"  ,z->sv))self->b=lv_shade(buffer_transpose(self->b));
+	else if(!strcmp("left"  ,z->sv))buffer_flip_h(self->b),self->b=lv_shade(buffer_transpose(self->b));
+	else if(!strcmp("right" ,z->sv))self->b=lv_shade(buffer_transpose(self->b)),buffer_flip_h(self->b);
 	else if(!strcmp("dither",z->sv))buffer_dither(self->b);
 	return self;
 }
@@ -658,7 +661,7 @@ lv* interface_font(lv*self,lv*i,lv*x){
 		ikey("space"){font_sw(self)=ln(x);return x;}
 		ikey("size" ){
 			lv*r=font_make(pair_max(getpair(x),(pair){1,1}));iwrite(r,lmistr("space"),ifield(self,"space"));
-			for(int z=0;z<96;z++)iindex(r,z,iindex(self,z,NULL));self->b=r->b;return x;
+			for(int z=0;z<96;z++)iindex(r,z,iindex(self,z,NULL));self->b=lv_shade(r->b);return x;
 		}
 	}else{
 		ikey("size"    )return lmpair((pair){font_w(self),font_h(self)});
@@ -676,7 +679,7 @@ lv* font_write(lv*x){return data_write("FNT",'0',x->b);}
 
 // Patterns interface
 
-unsigned int COLORS[]={
+LIL_LOCAL unsigned int COLORS[]={
 	0xFFFFFFFF,0xFFFFFF00,0xFFFF6500,0xFFDC0000,0xFFFF0097,0xFF360097,0xFF0000CA,0xFF0097FF,
 	0xFF00A800,0xFF006500,0xFF653600,0xFF976536,0xFFB9B9B9,0xFF868686,0xFF454545,0xFF000000,
 };
@@ -845,8 +848,8 @@ void draw_shadow(rect r,int fcol,int bcol,int solid){
 	if(solid)draw_rect(box_intersect(r,frame.clip),bcol);draw_box(r,0,fcol),draw_hline(r.x+3,r.x+r.w,r.y+r.h,fcol),draw_vline(r.x+r.w,r.y+2,r.y+r.h+1,fcol);
 }
 #define grower(n,t) {if(!n)n=calloc(n##_size=16,sizeof(t));if(n##_count==n##_size)n=realloc(n,sizeof(t)*(n##_size+=16));}
-pair*fringe ;int fringe_count=0,fringe_size=0;
-char*visited;int visited_size=0;
+LIL_LOCAL pair*fringe;LIL_LOCAL int fringe_count=0,fringe_size=0;
+LIL_LOCAL char*visited;LIL_LOCAL int visited_size=0;
 void fringe_push(pair x){grower(fringe,pair);fringe[fringe_count++]=x;}
 pair fringe_pop(void){return fringe[--fringe_count];}
 void draw_fill(pair r,int pattern,char*src){
@@ -901,7 +904,7 @@ void draw_fat_scaled(rect r,lv*buff,int opaque,char*pal,int frame_count,int scal
 		if(opaque||v!=0)draw_rect(rect_add((rect){dx*scale,dy*scale,scale,scale},offset),c>=32?c: p?1:0);
 	}
 }
-float*dither_err=NULL;int dither_err_size=0;float dither_threshold=0.5;
+LIL_LOCAL float*dither_err=NULL;LIL_LOCAL int dither_err_size=0;LIL_LOCAL float dither_threshold=0.5;
 void draw_dithered(rect r,lv*buff,int opaque,lv*mask){
 	if(r.w==0||r.h==0)return;pair s=buff_size(buff);int stride=2*r.w, m[]={0,1,r.w-2,r.w-1,r.w,stride-1};
 	if(!dither_err)dither_err=calloc(stride,sizeof(float)),dither_err_size=stride;
@@ -914,7 +917,7 @@ void draw_dithered(rect r,lv*buff,int opaque,lv*mask){
 		int c=!col;if(ms&&(opaque||c!=0)&&inclip(r.x+b,r.y+a))PIX(r.x+b,r.y+a)=c;
 	}
 }
-fpair*poly;int poly_count=0,poly_size=0;
+LIL_LOCAL fpair*poly;LIL_LOCAL int poly_count=0,poly_size=0;
 void poly_push(fpair x){grower(poly,fpair);poly[poly_count++]=x;}
 rect poly_bounds(void){
 	rect d={frame.clip.x+frame.clip.w,frame.clip.y+frame.clip.h,frame.clip.x,frame.clip.y};
@@ -974,7 +977,7 @@ void draw_9seg(rect r,lv*dst,lv*src,rect m,rect clip,int opaque,char*inv){
 }
 
 typedef struct {pair pos;char c;} glyph;
-glyph*glyphs;int glyph_count=0,glyph_size=0;
+LIL_LOCAL glyph*glyphs;LIL_LOCAL int glyph_count=0,glyph_size=0;
 void glyph_push(pair pos,char c){
 	if(!glyphs)glyphs=calloc(glyph_size=16,sizeof(glyph));
 	if(glyph_count==glyph_size)glyphs=realloc(glyphs,sizeof(glyph)*(glyph_size+=16));
@@ -1012,8 +1015,8 @@ rect draw_modalbox(pair s){
 enum field_align{align_left,align_center,align_right};
 typedef struct {rect pos;int line;char c;lv*font,*arg;} glyph_box;
 typedef struct {rect pos;pair range;} line_box;
-glyph_box*layout;int layout_count=0,layout_size=0;
-line_box*lines;int lines_count=0,lines_size=0;
+LIL_LOCAL glyph_box*layout;LIL_LOCAL int layout_count=0,layout_size=0;
+LIL_LOCAL line_box*lines;LIL_LOCAL int lines_count=0,lines_size=0;
 void layout_push(rect pos,int line,char c,lv*font,lv*arg){grower(layout,glyph_box);layout[layout_count++]=(glyph_box){pos,line,c,font,arg};}
 void lines_push (rect pos,pair range                    ){grower(lines ,line_box );lines [lines_count++]=(line_box){pos,range};}
 pair layout_plaintext(char*text,lv*font,int align,pair max){
@@ -1114,7 +1117,7 @@ lv* interface_sound(lv*self,lv*i,lv*x){
 			for(int z=0;z<n.x;z++)r->sv[z]=z>=data->c?0:data->sv[z]; // before splice
 			EACH(z,s)if(n.x+z>=0&&n.x+z<r->c)r->sv[n.x+z]=0xFF&(int)ln(s->lv[z]); // splice
 			for(int z=0;z<(data->c)-(n.x+n.y);z++)if(n.x+s->c+z>=0&&n.x+s->c+z<r->c)r->sv[n.x+s->c+z]=n.x+n.y+z>=data->c?0:data->sv[n.x+n.y+z]; // after splice
-			self->b=r;return x;
+			self->b=lv_shade(r);return x;
 		}else{GEN(r,n.y)lmn(((z+n.x<0||z+n.x>=data->c)?0:(signed char)data->sv[z+n.x]));return r;}
 	}
 	ikey("size"){if(x){sound_resize(self,ln(x));return x;}return lmn(data->c);}
@@ -1296,7 +1299,7 @@ lv* interface_bits(lv*self,lv*i,lv*x){
 
 // Pointer interface
 
-pair pointer={0,0}, pointer_start={0,0}, pointer_prev={0,0}, pointer_end={0,0}; int pointer_held=0, pointer_down=0, pointer_up=0;
+LIL_LOCAL pair pointer={0,0}, pointer_start={0,0}, pointer_prev={0,0}, pointer_end={0,0}; LIL_LOCAL int pointer_held=0, pointer_down=0, pointer_up=0;
 lv* interface_pointer(lv*self,lv*i,lv*x){
 	ikey("held" )return lmn(pointer_held);
 	ikey("down" )return lmn(pointer_down);
@@ -1322,7 +1325,7 @@ widget unpack_widget(lv*x){
 lv* value_inherit(lv*self,lv*key){
 	lv*card=dget(self->b,lmistr("card")),*r=dget(self->b,key);if(!contraption_is(card))return r;
 	lv*p=dget(ifield(ifield(card,"def"),"widgets"),ifield(self,"name"));if(!p)return r;
-	lv*v=iwrite(p,key,NULL);if(r&&v&&matchr(r,v))self->b=l_drop(key,self->b);return r?r:v;
+	lv*v=iwrite(p,key,NULL);if(r&&v&&matchr(r,v))self->b=lv_shade(l_drop(key,self->b));return r?r:v;
 }
 
 // Canvas interface
@@ -1569,7 +1572,7 @@ lv* rtext_is_image(lv*x){
 int rtext_append(lv*table,lv*text,lv*font,lv*arg){
 	if(image_is(arg)){if(text->c>1)text=lmistr("i");if(text->c<1)return 0;}if(!text->c)return 0; // NOTE: this routine modifies <table> in place!
 	lv*t=dget(table,lmistr("text")),*f=dget(table,lmistr("font")),*a=dget(table,lmistr("arg"));
-	if(t->c&&matchr(font,l_last(f))&&!image_is(arg)&&matchr(arg,l_last(a))){str u=str_new();str_addl(&u,t->lv[t->c-1]),str_addl(&u,text),t->lv[t->c-1]=lmstr(u);}
+	if(t->c&&matchr(font,l_last(f))&&!image_is(arg)&&matchr(arg,l_last(a))){str u=str_new();str_addl(&u,t->lv[t->c-1]),str_addl(&u,text),t->lv[t->c-1]=lv_shade(lmstr(u));}
 	else{ll_add(t,text),ll_add(f,font),ll_add(a,arg);}torect(table);return text->c;
 }
 void rtext_appendr(lv*table,lv*suffix){
@@ -1615,9 +1618,9 @@ lv* rtext_cast(lv*x){
 	{lv*v=dget(x,a);dset(r,a,v?v:l_list(lmistr("")));}
 	torect(r);for(int z=0;z<r->n;z++){
 		int i=image_is(r->lv[2]->lv[z]);
-		r->lv[0]->lv[z]=i?lmistr("i"):ls(r->lv[0]->lv[z]);
-		r->lv[1]->lv[z]=ls(r->lv[1]->lv[z]);
-		r->lv[2]->lv[z]=i?r->lv[2]->lv[z]:ls(r->lv[2]->lv[z]);
+		r->lv[0]->lv[z]=lv_shade(i?lmistr("i"):ls(r->lv[0]->lv[z]));
+		r->lv[1]->lv[z]=lv_shade(ls(r->lv[1]->lv[z]));
+		r->lv[2]->lv[z]=lv_shade(i?r->lv[2]->lv[z]:ls(r->lv[2]->lv[z]));
 	}return torect(r);
 }
 lv* rtext_splice(lv*table,lv*font,lv*arg,char*text,pair cursor,pair*endcursor){
@@ -1648,10 +1651,14 @@ lv* rtext_encode(lv*x){str r=str_new();str_addz(&r,"%%RTX0");fjson(&r,rtext_writ
 lv* rtext_decode(lv*x){int f=1,i=6,n=x->c-i;lv*v=rtext_read(pjson(x->sv,&i,&f,&n));return v;}
 lv*n_rtext_split(lv*self,lv*z){
 	(void)self;if(z->c<2)return lml(0);lv*d=ls(z->lv[0]),*v=rtext_cast(z->lv[1]),*t=rtext_string(v,(pair){0,RTEXT_END}),*r=lml(0);
-	if(d->c<1)return r;int n=0;EACH(z,t){
-		int m=1;EACH(w,d)if(d->sv[w]!=t->sv[z+w]){m=0;break;}if(!m)continue;
-		ll_add(r,rtext_span(v,(pair){n,z})),z+=d->c-1,n=z+1;
-	}if(n<=t->c)ll_add(r,rtext_span(v,(pair){n,t->c}));return r;
+	if(d->c<1)return r;int n=0,x;while((x=str_find(t->sv+n,t->c-n,d->sv,d->c))>=0){ll_add(r,rtext_span(v,(pair){n,n+x}));n+=x+d->c;}
+	ll_add(r,rtext_span(v,(pair){n,t->c}));return r;
+}
+int rtext_leads(lv*k,int nocase,char*lead){ // flag the leading characters of every key; 1 if any key is empty.
+	int r=0;memset(lead,0,256);EACH(z,k){
+		lv*key=k->lv[z];if(!key->c){r=1;continue;}unsigned char c=key->sv[0];
+		lead[c]=1;if(nocase)lead[tolower(c)]=1,lead[toupper(c)]=1;
+	}return r;
 }
 lv*n_rtext_len   (lv*self,lv*z){(void)self;return lmn(rtext_len(rtext_cast(l_first(z))));}
 lv*n_rtext_get   (lv*self,lv*z){(void)self;return lmn(rtext_get(rtext_cast(l_first(z)),z->c<2?0:ln(z->lv[1])));}
@@ -1661,9 +1668,10 @@ lv*n_rtext_cat   (lv*self,lv*z){(void)self;lv*r=l_take(NONE,rtext_cast(lmt()));E
 lv*n_rtext_replace(lv*self,lv*z){
 	if(z->c<3)return l_first(z);lv*t=rtext_cast(z->lv[0]),*k=z->lv[1],*v=z->lv[2],*r=lml(0),*text=rtext_string(t,(pair){0,RTEXT_END});
 	if(!lil(k))k=l_list(k);if(!lil(v))v=l_list(v);int nocase=z->c>=4&&lb(z->lv[3]);
-	k=l_take(lmn(MAX(k->c,v->c)),l_drop(lmistr(""),k));EACH(z,k)k->lv[z]=ls(k->lv[z]);
-	v=l_take(lmn(MAX(k->c,v->c)),v);EACH(z,v)v->lv[z]=rtext_cast(v->lv[z]);
-	pair c={0,0};while(c.y<text->c){
+	k=l_take(lmn(MAX(k->c,v->c)),l_drop(lmistr(""),k));EACH(z,k)k->lv[z]=lv_shade(ls(k->lv[z]));
+	v=l_take(lmn(MAX(k->c,v->c)),v);EACH(z,v)v->lv[z]=lv_shade(rtext_cast(v->lv[z]));
+	char lead[256];rtext_leads(k,nocase,lead);pair c={0,0};while(c.y<text->c){
+		while(c.y<text->c&&!lead[0xFF&text->sv[c.y]])c.y++;if(c.y>=text->c)break; // skip to a plausible match
 		int any=0;EACH(ki,k){
 			lv*key=k->lv[ki],*val=v->lv[ki];int f=1;
 			if(nocase){EACH(i,key)if(tolower(text->sv[c.y+i])!=tolower(key->sv[i])){f=0;break;}}
@@ -1675,8 +1683,9 @@ lv*n_rtext_replace(lv*self,lv*z){
 lv*n_rtext_find(lv*self,lv*z){
 	(void)self;lv*r=lml(0);if(z->c<2)return r;int nocase=z->c>=3&&lb(z->lv[2]);
 	lv*text=lit(z->lv[0])?rtext_all(rtext_cast(z->lv[0])): ls(z->lv[0]), *k=z->lv[1];
-	if(!lil(k))k=l_list(k);EACH(z,k)k->lv[z]=ls(k->lv[z]);
+	if(!lil(k))k=l_list(k);EACH(z,k)k->lv[z]=lv_shade(ls(k->lv[z]));char lead[256];int e=rtext_leads(k,nocase,lead);
 	for(int x=0;x<text->c;){
+		if(!e)while(x<text->c&&!lead[0xFF&text->sv[x]])x++;if(x>=text->c)break; // skip to a plausible match
 		int any=0;EACH(ki,k){
 			lv*key=k->lv[ki];int f=1;
 			if(nocase){EACH(i,key)if(tolower(text->sv[x+i])!=tolower(key->sv[i])){f=0;break;}}
@@ -2031,7 +2040,7 @@ lv* interface_widget(lv*self,lv*i,lv*x){
 	if(x){
 		ikey("name"  ){
 			int ix=dgeti(widgets,name);lv*n=ukey(widgets,ls(x),ls(x)->sv,dget(data,i));
-			widgets->kv[ix]=n;dset(widgets->lv[ix]->b,lmistr("name"),n);return x;
+			widgets->kv[ix]=lv_shade(n);dset(widgets->lv[ix]->b,lmistr("name"),n);return x;
 		}
 		ikey("index"   ){reorder(widgets,dgeti(widgets,name),ln(x));return x;}
 		ikey("font"    ){dset(data,i,normalize_font(fonts,x));return x;}
@@ -2106,7 +2115,7 @@ lv* interface_keystore(lv*self,lv*i,lv*x){
 	i=ls(i);ikey("keys")return l_keys(self->b);
 	if(x){
 		lv*f=lmistr("%j");x=l_parse(f,l_format(f,x));
-		if(matchr(NONE,x)){self->b=l_drop(i,self->b);}else{dset(self->b,i,x);}return x;
+		if(matchr(NONE,x)){self->b=lv_shade(l_drop(i,self->b));}else{dset(self->b,i,x);}return x;
 	}else{return dgetv(self->b,i);}
 }
 lv* keystore_make(lv*x){
@@ -2124,7 +2133,7 @@ lv* interface_module(lv*self,lv*i,lv*x){
 		ikey("name"){
 			lv*name=ivalue(self,"name");
 			if(ls(x)->c==0){return x;}lv*n=ukey(modules,ls(x),ls(x)->sv,dget(data,i));
-			modules->kv[dgeti(modules,name)]=n;dset(data,i,n);return x;
+			modules->kv[dgeti(modules,name)]=lv_shade(n);dset(data,i,n);return x;
 		}
 		ikey("script"){
 			dset(data,i,ls(x)),dset(data,lmistr("error"),lmistr("")),dset(data,lmistr("value"),lmd());
@@ -2254,7 +2263,7 @@ lv* interface_card(lv*self,lv*i,lv*x){
 	if(x){
 		ikey("name"){
 			if(ls(x)->c==0){return x;}lv*n=ukey(cards,ls(x),ls(x)->sv,dget(data,i));
-			cards->kv[dgeti(cards,name)]=n;dset(data,i,n);return x;
+			cards->kv[dgeti(cards,name)]=lv_shade(n);dset(data,i,n);return x;
 		}
 		ikey("script"){dset(data,i,ls(x));return x;}
 		ikey("image" ){dset(data,i,image_is(x)?x:image_empty());return x;}
@@ -2314,7 +2323,7 @@ void contraption_update(lv*def){
 			lv*widget=widgets->lv[w];if(!contraption_is(widget)||ifield(widget,"def")!=def)continue;
 			lv*d=widget_write(widget),*n=ifield(widget,"name");
 			dset(d,lmistr("widgets"),contraption_strip(widget));
-			widget->b=widget_read(d,card)->b;dset(widget->b,lmistr("name"),n);
+			widget->b=lv_shade(widget_read(d,card)->b);dset(widget->b,lmistr("name"),n);
 		}
 	}
 }
@@ -2342,7 +2351,7 @@ lv* interface_prototype(lv*self,lv*i,lv*x){
 	if(x){
 		ikey("name"){
 			lv*o=dget(data,i),*n=ukey(defs,ls(x),ls(x)->sv,o);
-			defs->kv[dgeti(defs,o)]=n;dset(data,i,n);return x;
+			defs->kv[dgeti(defs,o)]=lv_shade(n);dset(data,i,n);return x;
 		}
 		ikey("description"){dset(data,i,ls(x));return x;}
 		ikey("version"    ){dset(data,i,lmn(ln(x)));return x;}
@@ -2414,7 +2423,7 @@ lv* prototype_read(lv*x,lv*deck){
 
 void rename_sound(lv*deck,lv*sound,lv*name){
 	lv*sounds=dget(deck->b,lmistr("sounds")),*oldname=dkey(sounds,sound);
-	sounds->kv[dgeti(sounds,oldname)]=ukey(sounds,ls(name),ls(name)->sv,oldname);
+	sounds->kv[dgeti(sounds,oldname)]=lv_shade(ukey(sounds,ls(name),ls(name)->sv,oldname));
 }
 lv* n_deck_copy(lv*deck,lv*z){
 	(void)deck;z=l_first(z);if(!card_is(z))return NONE;
@@ -2452,7 +2461,7 @@ lv* n_deck_add(lv*self,lv*z){
 	if(prototype_is(t)){
 		if(z->c<2&&dget(defs,ifield(t,"name"))){ // replace
 			lv*name=ifield(t,"name"),*r=dget(defs,name);
-			r->b=prototype_read(prototype_write(t),self)->b;dset(r->b,lmistr("name"),name);
+			r->b=lv_shade(prototype_read(prototype_write(t),self)->b);dset(r->b,lmistr("name"),name);
 			contraption_update(r);return r;
 		}else{ // insert
 			lv*a=prototype_write(t);if(z->c>1)dset(a,lmistr("name"),unpack_str(z,1));
@@ -2901,7 +2910,15 @@ lv* n_read(lv*self,lv*a){
 	char head[]={0,0,0},ref[]={0xEF,0xBB,0xBF};if(fread(head,1,sizeof(head),f)!=sizeof(head)){fclose(f);return lms(0);}
 	int bom=memcmp(head,ref,sizeof(head))==0; // UTF-8 BOM
 	lv*r=lms(st.st_size-(bom?3:0));fseek(f,bom?3:0,SEEK_SET);if(fread(r->sv,1,r->c,f)!=(unsigned)r->c){fclose(f);return lms(0);}
-	fclose(f);str rr=str_new();str_addz(&rr,r->sv);return lmstr(rr); // clean invalid chars, including \r
+	fclose(f);str rr=str_new();str_provision(&rr,r->c+1),str_addz(&rr,r->sv);return lmstr(rr); // clean invalid chars, including \r
+}
+lv* readcsvfile(lv*path,lv*a){ // as readcsv[read[path] ...a], but streamed from the file in chunks
+	FILE*f=fopen(path->sv,"rb");csv_src in={str_new(),f,!f,0,{0}};char head[]={0,0,0},ref[]={0xEF,0xBB,0xBF};
+	if(f){if(fread(head,1,sizeof(head),f)!=sizeof(head))in.eof=1;else if(memcmp(head,ref,sizeof(head)))fseek(f,0,SEEK_SET);}
+	lv*r=readcsv(&in,a);if(f)fclose(f);free(in.b.sv);return r;
+}
+lv* writecsvfile(lv*path,lv*a){ // as write[path writecsv[...a]], but drained to the file in chunks
+	FILE*f=fopen(path->sv,"w");if(!f)return NONE;csv_sink o={str_new(),f};writecsv(&o,a);fclose(f);free(o.b.sv);return ONE;
 }
 lv* writebin(lv*path,lv*x){array a=unpack_array(x);FILE*f=fopen(path->sv,"wb");if(f)fwrite(a.data->sv,1,a.data->c,f),fclose(f);return f?ONE:NONE;}
 lv* n_write(lv*self,lv*a){
@@ -2920,7 +2937,7 @@ lv* idecode(lv*x){
 #define PATH_MAX 4096
 #endif
 typedef struct {int dir;char name[PATH_MAX];} dir_item;
-dir_item*directory;int directory_count=0,directory_size=0;
+LIL_LOCAL dir_item*directory;LIL_LOCAL int directory_count=0,directory_size=0;
 enum file_filter{filter_none,filter_deck,filter_data,filter_code,filter_sound,filter_image,filter_gif};
 void directory_push(int dir,char*name,int filter){
 	if(name[0]=='.')return;
@@ -3055,6 +3072,7 @@ lv*n_writefile(lv*self,lv*a){
 	if(array_is(value))return writebin(l_first(a),value);
 	if(sound_is(value))return n_writewav(self,a);
 	if(image_is(value)||lid(value))return n_writegif(self,a);
+	if(lit(value))return writecsvfile(ls(l_first(a)),l_drop(ONE,a));
 	if(lil(value)){EACH(z,value)if(image_is(value->lv[z]))return n_writegif(self,a);}
 	return n_write(self,a);
 }
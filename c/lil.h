@@ -7,14 +7,28 @@
 #include <ctype.h>
 #include <time.h>
 #endif
+#ifndef LIL_LOCAL // interpreter state is per-thread, so that each thread may run an interpreter of its own.
+                  // hosts whose threads take turns with one shared interpreter (like decker.c) define LIL_LOCAL as empty.
+#if __STDC_VERSION__>=201112L
+#define LIL_LOCAL _Thread_local
+#else
+#define LIL_LOCAL __thread
+#endif
+#endif
 
 typedef struct{int c,size;char*sv;}str;
 typedef struct lvs{int t,c,n,s,ns,g;double nv;char*sv;struct lvs**lv,**kv,*a,*b,*env;void*f;}lv;
 typedef struct{int c,size,*iv;}idx;
-typedef struct{lv*p,*t,*e;idx pcs;}pstate;pstate state={0}; // parameters, tasks, envs, index
-typedef struct{int lo,hi,live,size,g,ss;lv**heap;long frees,allocs,depth;pstate st[4];}gc_state;gc_state gc={0};
+typedef struct{lv*p,*t,*e;idx pcs;}pstate;LIL_LOCAL pstate state={0}; // parameters, tasks, envs, index
+typedef struct{int lo,hi,live,size,g,ss,sw,sweeping,marking;lv**heap;long frees,allocs,depth,ops;pstate st[4];}gc_state;LIL_LOCAL gc_state gc={0};
+typedef struct{long ops[32],bytes[10],finds,probes,lookups,hops,maxhops;double pause,maxpause,last;}telemetry;LIL_LOCAL telemetry tel={0}; // see workspace()
+#ifndef LIL_NO_TELEMETRY // counters bumped on every lookup and op; define LIL_NO_TELEMETRY to leave them out (workspace() shows 0).
+#define TALLY(x) (x)
+#else
+#define TALLY(x) ((void)0)
+#endif
 typedef struct{char*name;void*func;}primitive;
-int seed=0x12345;lv interned[1024]={{0}};unsigned int intern_count=383+1, do_panic=0;
+LIL_LOCAL int seed=0x12345;LIL_LOCAL lv interned[1024]={{0}};LIL_LOCAL unsigned int intern_count=383+1, do_panic=0;
 #define intern_num {if(x==floor(x)&&x>=-128&&x<=255)return &interned[((int)x)+128];}
 lv*n_show (lv*self,lv*a); // user-supplied function which displays raw to stdout.
 lv*n_print(lv*self,lv*a); // user-supplied function which formats/displays to stdout.
@@ -29,7 +43,7 @@ lv*idecode(lv*x);         // decode datablock representation of interfaces into
 #define MIN(a,b)     ((a)<(b)?(a):(b))
 #define SIGN(x)      (x>0?1:-1)
 #define EACH(v,x)    for(int v=0;v<x->c;v++)
-#define FIND(v,x,k)  for(int v=0;v<x->c;v++)if(matchr(x->kv[v],k))
+#define FIND(v,x,k)  for(int v=(TALLY(tel.finds++),0);v<x->c;v++)if(TALLY(tel.probes++),matchr(x->kv[v],k))
 #define SFIND(v,x,k) for(int v=0;v<x->c;v++)if(k==x->kv[z]->sv||!strcmp(x->kv[z]->sv,k))
 #define EACHR(v,x)   for(int v=x->c-1;v>=0;v--)
 #define GEN(v,n)     lv*v=lml(n);   for(int z=0;z<n   ;z++)v->lv[z]=
@@ -49,8 +63,19 @@ void str_provision(str*s,int size){if(s->size<size)s->sv=realloc(s->sv,s->size=s
 void str_addraw(str*s,int x){if(s->c+1>=s->size)s->sv=realloc(s->sv,s->size*=2);s->sv[s->c++]=x;}
 void str_term(str*s){str_addraw(s,'\0');}
 void str_addc(str*s,char x){if(x!='\r')str_addraw(s,cl(x));}
+void str_addn(str*s,char*x,int n){ // bulk append of bytes which are already valid lil characters
+	if(s->c+n+1>s->size){int z=MAX(32,s->size);while(z<s->c+n+1)z*=2;s->sv=realloc(s->sv,s->size=z);}memcpy(s->sv+s->c,x,n);s->c+=n;
+}
+int str_plain(char*x,int n){ // length of the leading run of x which is already valid lil characters, scanned a word at a time
+	#define WB(v) (0x0101010101010101ull*(v))
+	int z=0;while(z<n){unsigned long long w,m; // a word is plain if no byte has the high bit, is below 32, or is 127
+		while(z+8<=n&&(memcpy(&w,x+z,8),m=w&WB(0x7F),!((w|~(m+WB(0x60))|(m+WB(1)))&WB(0x80))))z+=8;
+		if(z<n&&((x[z]>=32&&x[z]<=126)||x[z]=='\n'))z++;else break;
+	}return z;
+	#undef WB
+}
 void str_add(str*s,char*x,int n){
-	for(int z=0;z<n;z++){unsigned char c=x[z];
+	for(int z=0;z<n;z++){int r=z+str_plain(x+z,n-z);str_addn(s,x+z,r-z);if((z=r)>=n)break;unsigned char c=x[z];
 		if(c==0xE2&&(unsigned char)x[z+1]==0x80&&((unsigned char)x[z+2]==0x98||(unsigned char)x[z+2]==0x99))c='\'',z+=2;
 		if(c==0xE2&&(unsigned char)x[z+1]==0x80&&((unsigned char)x[z+2]==0x9C||(unsigned char)x[z+2]==0x9D))c='"' ,z+=2;
 		if((c&0xF0)==0xF0)c=1,z+=3; // skip 4-byte codepoints
@@ -59,61 +84,130 @@ void str_add(str*s,char*x,int n){
 		str_addc(s,c);
 	}
 }
+void str_addr(str*s,char*x,int n){ // same as str_addc() per byte, but plain runs are copied in bulk
+	for(int z=0;z<n;){int r=z+str_plain(x+z,n-z);str_addn(s,x+z,r-z);if(r<n)str_addc(s,x[r++]);z=r;}
+}
 void str_addz(str*s,char*x){str_add(s,x,strlen(x));} // null-terminated c-string
 void str_addl(str*s,lv*x){str_add(s,x->sv,x->c);}    // counted lil string
+int str_find(char*h,int hn,char*n,int nn){ // offset of the first occurrence of n in h, or -1.
+	if(nn<1)return 0;char*p=h,*e=h+hn-nn+1; // memchr() skips ahead on the first byte, memcmp() verifies the rest.
+	while(p<e&&(p=memchr(p,n[0],e-p))){if(!memcmp(p+1,n+1,nn-1))return p-h;p++;}return -1;
+}
 lv*  ll_peek(lv*x){return x->c?x->lv[x->c-1]:NULL;}
 lv*  ll_pop(lv*x){return x->c?x->lv[--(x->c)]:NULL;}
 lv*  ll_unshift(lv*x){lv*r=x->c?x->lv[0]:NULL;for(int z=0;z<x->c-1;z++)x->lv[z]=x->lv[z+1];x->c--;return r;}
-void ll_add(lv*x,lv*y){if(x->s<x->c+1)x->lv=realloc(x->lv,(x->s*=2)*sizeof(lv*));x->lv[x->c++]=y;}
+// small lists and envs keep their first few slots (and an env its keys, after them) in the same allocation as the value:
+#define lv_inline(x)  ((x)->lv==(lv**)((x)+1))
+#define kv_inline(x)  (lv_inline(x)&&(x)->kv==(x)->lv+(x)->s)
+void lv_spill(lv*x){ // move inline slots to the heap, before they grow
+	lv**v=malloc(x->s*sizeof(lv*));memcpy(v,x->lv,x->c*sizeof(lv*));
+	if(kv_inline(x)){lv**k=malloc(x->s*sizeof(lv*));memcpy(k,x->kv,x->c*sizeof(lv*));x->kv=k;}x->lv=v;
+}
+lv* lv_shade(lv*x); // the write barrier, below: anything stored into a value which may already exist goes through it
+void ll_add(lv*x,lv*y){if(x->s<x->c+1){if(lv_inline(x))lv_spill(x);x->lv=realloc(x->lv,(x->s*=2)*sizeof(lv*));}x->lv[x->c++]=lv_shade(y);}
 void ld_add(lv*d,lv*k,lv*x){
-	if(d->c+1>d->s){
+	if(d->c+1>d->s){if(lv_inline(d))lv_spill(d);
 		d->s*=2;d->kv=realloc(d->kv,d->s*sizeof(lv*));d->lv=realloc(d->lv,d->s*sizeof(lv*));
-	}d->kv[d->c]=k,d->lv[d->c]=x,d->c++;
-}
-void lv_walk(lv*x){
-	if(x==NULL||x->g==gc.g){return;}x->g=gc.g;
-	if(x->lv)EACH(z,x)lv_walk(x->lv[z]);if(x->kv)EACH(z,x)lv_walk(x->kv[z]);
-	lv_walk(x->a),lv_walk(x->b),lv_walk(x->env);
-}
+	}d->kv[d->c]=lv_shade(k),d->lv[d->c]=lv_shade(x),d->c++;
+}
+double lv_clock(void){ // milliseconds of wall time, for gc pauses: clock() would count the cpu time of every thread
+	#ifdef _WIN32
+	return clock()*1000.0/CLOCKS_PER_SEC; // which is wall time on windows
+	#else
+	struct timespec t;clock_gettime(CLOCK_MONOTONIC,&t);return t.tv_sec*1000.0+t.tv_nsec/1e6;
+	#endif
+}
+typedef struct{lv**v;int c,size,over;void(*visit)(lv*);}mark_stack;LIL_LOCAL mark_stack mark={0};
+#define MARK_MAX (1<<20) // past this many values awaiting a scan, fall back to rescanning the heap
+void lv_mark(lv*x){
+	if(x==NULL||x->g==gc.g){return;}x->g=gc.g;if(mark.visit)mark.visit(x);
+	if(!x->lv&&!x->kv&&!x->a&&!x->b&&!x->env)return;
+	if(mark.c>=mark.size){
+		if(mark.size>=MARK_MAX){mark.over=1;return;}
+		mark.size=mark.size?mark.size*2:1024,mark.v=realloc(mark.v,mark.size*sizeof(lv*));
+	}mark.v[mark.c++]=x;
+}
+lv* lv_shade(lv*x){if(gc.marking)lv_mark(x);return x;} // while marking is under way, a value stored into one already
+                                                       // scanned would be missed, so it's marked as it's stored.
+void lv_scan(lv*x){
+	if(x->lv)EACH(z,x)lv_mark(x->lv[z]);if(x->kv)EACH(z,x)lv_mark(x->kv[z]);
+	lv_mark(x->a),lv_mark(x->b),lv_mark(x->env);
+}
+int lv_drain(double until){ // scan marked values until none are left (1) or lv_clock() passes 'until' (0)
+	for(int n=1;mark.c;n++){lv_scan(mark.v[--mark.c]);if(until&&(n&255)==0&&lv_clock()>until)return 0;}
+	while(mark.over){ // some marked values were dropped before being scanned: find them by rescanning every marked value
+		mark.over=0;for(int z=0;z<gc.size;z++)if(gc.heap[z]&&gc.heap[z]->g==gc.g){lv_scan(gc.heap[z]);while(mark.c)lv_scan(mark.v[--mark.c]);}
+	}return 1;
+}
+void lv_walk(lv*x){lv_mark(x),lv_drain(0);}
 void lv_free(lv*x){
 	if(!x)return;
-	if(x->lv)free(x->lv);if(x->kv)free(x->kv);if(x->sv&&!(x->t==1&&x->b))free(x->sv);free(x);gc.frees++,gc.live--;
+	if(x->kv&&!kv_inline(x))free(x->kv);if(x->lv&&!lv_inline(x))free(x->lv);if(x->t==7&&x->f)free(((idx*)x->f)->iv),free(x->f);if(x->t==2&&x->f)free(x->f);if(x->sv&&!(x->t==1&&x->b))free(x->sv);free(x);gc.frees++,gc.live--;
 }
 void lv_grow(void){
 	gc.heap=realloc(gc.heap,(gc.size*2)*sizeof(lv*));
 	memset(gc.heap+gc.size,0,gc.size*sizeof(lv*));gc.size*=2;
 }
-void lv_collect(void){
-	if(gc.live+(gc.size*0.1)<gc.size)return;gc.g++;
-	for(int z=0;z<gc.ss;z++){lv_walk(gc.st[z].e),lv_walk(gc.st[z].p),lv_walk(gc.st[z].t);}
-	lv_walk(state.e),lv_walk(state.p),lv_walk(state.t);
-	for(int z=0;z<gc.hi;z++)if(gc.heap[z]){
+int lv_sweep(double until){ // free unmarked values until the sweep is finished (1) or lv_clock() passes 'until' (0)
+	for(int z=gc.sw;z<gc.hi;z++){
+		if(until&&z>gc.sw&&(z&255)==0&&lv_clock()>until){gc.sw=z;return 0;}
+		if(!gc.heap[z])continue;
 		if(gc.heap[z]->g!=gc.g){lv_free(gc.heap[z]),gc.heap[z]=NULL,gc.lo=MIN(gc.lo,z);}
 		else{gc.hi=MAX(gc.hi,z);}
-	}
+	}gc.sweeping=0;if(gc.live>gc.size*0.75)lv_grow(); // reclaiming little means collecting again soon; grow rather than thrash
+	return 1;
+}
+void lv_pause(double start){double t=lv_clock()-start;tel.pause+=t,tel.last=t,tel.maxpause=MAX(tel.maxpause,t);}
+// a collection marks everything reachable from the interpreter states, then sweeps away the rest. lv_collect_slice()
+// spreads both over many calls, between which the interpreter runs: values allocated while marking is under way start out
+// unmarked, and are kept only if they're reachable when it finishes (or are stored into an existing value, see lv_shade()).
+// values allocated while sweeping carry the current mark, so the sweep never frees them.
+void lv_mark_roots(void){
+	for(int z=0;z<gc.ss;z++){lv_mark(gc.st[z].e),lv_mark(gc.st[z].p),lv_mark(gc.st[z].t);}
+	lv_mark(state.e),lv_mark(state.p),lv_mark(state.t);
+}
+void lv_mark_begin(void){gc.g++,gc.marking=1;lv_mark_roots();}
+void lv_mark_end(void){lv_mark_roots(),lv_drain(0);gc.marking=0,gc.sw=0,gc.sweeping=1;} // the states may have been replaced
+void lv_settle(void){
+	// abandon any marking under way, and finish any sweep, so the marks may be used for something else.
+	// (finishing the marking instead would miss values held only by the caller, in c variables.)
+	if(gc.marking)gc.marking=0,mark.c=0,mark.over=0;if(gc.sweeping)lv_sweep(0);
+}
+void lv_collect(void){ // collect all at once, if the heap is nearly full
+	if(gc.live+(gc.size*0.1)<gc.size)return;double start=lv_clock();if(gc.marking)lv_mark_end();if(gc.sweeping)lv_sweep(0);
+	if(gc.live+(gc.size*0.1)>=gc.size)lv_mark_begin(),lv_mark_end(),lv_sweep(0);lv_pause(start);
+}
+void lv_collect_slice(long us){ // collect a little at a time, in calls of at most 'us' microseconds (give or take a few hundred values)
+	double start=lv_clock(),until=start+us/1000.0;tel.last=0;
+	if(!gc.marking&&!gc.sweeping){if(gc.live+(gc.size*0.1)<gc.size)return;lv_mark_begin();}
+	if(gc.marking&&lv_drain(until))lv_mark_end();if(gc.sweeping)lv_sweep(until);lv_pause(start);
 }
 int lv_stash(lv*x){
 	while(gc.lo<gc.size&&gc.heap[gc.lo]!=NULL)gc.lo++;
 	return(gc.lo>=gc.size)?0: (gc.heap[gc.lo]=x,gc.hi=MAX(gc.hi,gc.lo),gc.lo++,1);
 }
-lv* lmv(int type){
-	gc.allocs++,gc.live++;lv*r=calloc(1,sizeof(lv));r->t=type;
+lv* lmvx(int type,int extra){
+	gc.allocs++,gc.live++,tel.bytes[type]+=sizeof(lv)+extra;lv*r=calloc(1,sizeof(lv)+extra);r->t=type,r->g=gc.g-gc.marking;
 	if(gc.heap==NULL){gc.size=64,gc.heap=calloc(gc.size,sizeof(lv*));}
 	if(lv_stash(r))return r;lv_grow();lv_stash(r);return r;
 }
-lv* lmvv(int t,int n){lv*r=lmv(t);r->lv=calloc(r->s=MAX(n,8),sizeof(lv*));r->c=n;return r;}
+lv* lmv(int type){return lmvx(type,0);}
+lv* lmvv(int t,int n){
+	if(n<=8){lv*r=lmvx(t,8*sizeof(lv*));r->lv=(lv**)(r+1),r->s=8,r->c=n;return r;}
+	lv*r=lmv(t);r->lv=calloc(r->s=n,sizeof(lv*));r->c=n;tel.bytes[t]+=r->s*sizeof(lv*);return r;
+}
 #define lm(n,c) int li##n(lv*x){return x&&x->t==c;} lv*lm##n
 lm(n  ,0)(double x){intern_num;lv*r=lmv(0);r->c=1,r->nv=isfinite(x)?x:0;                 return r;}
-lm(s  ,1)(int n)           {lv*r=lmv(1);r->c=n;r->sv=calloc(n+1,1);                      return r;}
+lm(s  ,1)(int n)           {lv*r=lmv(1);r->c=n;r->sv=calloc(n+1,1);tel.bytes[1]+=n+1;     return r;}
 lm(l  ,2)(int n)           {lv*r=lmvv(2,n);                                              return r;}
-lm(d  ,3)(void)            {lv*r=lmvv(3,16);r->c=0,r->kv=calloc(16,sizeof(lv*));         return r;}
-lm(t  ,4)(void)            {lv*r=lmvv(4,16);r->c=0,r->kv=calloc(16,sizeof(lv*));         return r;}
+lm(d  ,3)(void)            {lv*r=lmvv(3,16);r->c=0,r->kv=calloc(16,sizeof(lv*));tel.bytes[3]+=16*sizeof(lv*);return r;}
+lm(t  ,4)(void)            {lv*r=lmvv(4,16);r->c=0,r->kv=calloc(16,sizeof(lv*));tel.bytes[4]+=16*sizeof(lv*);return r;}
 lm(on ,5)(str n,lv*r,lv*b) {r->t=5,r->sv=n.sv,r->b=b;                                    return r;}
 lm(i  ,6)(lv*(*f)(lv*,lv*,lv*),lv*n,lv*s){lv*r=lmv(6);r->f=(void*)f,r->a=n,r->b=s;       return r;}
 lm(blk,7)(void)            {lv*r=lmvv(7,0);r->sv=calloc(32,sizeof(char)),r->ns=32,r->n=0;return r;}
-lm(env,8)(lv*p)            {lv*r=lmd();r->t=8;r->env=p;                                  return r;}
+lm(env,8)(lv*p)            {lv*r=lmvx(8,16*sizeof(lv*));r->lv=(lv**)(r+1),r->kv=r->lv+8,r->s=8,r->env=p;return r;}
 lm(nat,9)(lv*(*f)(lv*,lv*),lv*c){lv*r=lmv(9);r->f=(void*)f,r->a=c;                       return r;}
-lv* lmstr(str x){lv*r=lmv(1);str_term(&x),r->c=strlen(x.sv);r->sv=x.sv;return r;}
+lv* lmstr(str x){lv*r=lmv(1);str_term(&x),r->c=strlen(x.sv);r->sv=x.sv;tel.bytes[1]+=x.size;return r;}
 lv* lmcstr(char*x){lv*r=lmv(1);r->c=strlen(x),r->sv=calloc(r->c+1,1),memcpy(r->sv,x,r->c);return r;}
 lv* lmutf8(char*x){str r=str_new();str_addz(&r,x);return lmstr(r);}
 lv* lmistr(char*x){
@@ -124,21 +218,31 @@ lv* lmistr(char*x){
 lv* lmslice(lv*x,int off){lv*r=lmv(1);r->c=MAX(0,x->c-off),r->b=x->b?x->b:x;r->sv=x->sv+MIN(MAX(0,off),x->c);return r;}
 int     mod(int    x,int    y){x=y==0?0:x%y      ;if(x<0)x+=y;return x;}
 double dmod(double x,double y){x=y==0?0:fmod(x,y);if(x<0)x+=y;return x;}
+static const double p10[]={1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22};
+double pjson_num(char*t,int n){ // exact for mantissas up to 15 digits with small exponents; otherwise defer to atof().
+	unsigned long long m=0;int z=n>0&&t[0]=='-',s=z,d=0,e=0;
+	while(z<n&&isdigit(t[z]))m=m*10+(t[z++]-'0'),d++;
+	if(z<n&&t[z]=='.'){z++;while(z<n&&isdigit(t[z]))m=m*10+(t[z++]-'0'),d++,e--;}
+	if(z<n&&(t[z]=='e'||t[z]=='E')){
+		z++;int es=z<n&&t[z]=='-'?-1:1,x=0;if(z<n&&strchr("+-",t[z]))z++;
+		while(z<n&&isdigit(t[z])){x=x*10+(t[z++]-'0');if(x>9999)x=9999;}e+=es*x;
+	}if(d<=15&&e>=-22&&e<=22){double r=e<0?m/p10[-e]:m*p10[e];return s?-r:r;}
+	char tb[NUM];snprintf(tb,MIN(n+1,NUM),"%s",t);return atof(tb);
+}
 double rnum_len(char*x,int n,int*len){
-	if(n==0)return 0;int i=0,sign=1;double r=0,p=10;while(isspace(x[i]))i++;
-	if(x[0]=='-')sign=-1,i++;while(i<n&&isdigit(x[i]))r=r*10+(x[i]-'0'),i++;
-	if(x[i]=='.')        i++;while(i<n&&isdigit(x[i]))r+=(x[i++]-'0')/p,p*=10;
-	return (*len)=i,sign*r;
+	if(n==0)return 0;int i=0,sign=1,d=0,e=0;unsigned long long m=0;while(isspace(x[i]))i++;
+	if(x[0]=='-')sign=-1,i++;int s=i;while(i<n&&isdigit(x[i]))m=m*10+(x[i++]-'0'),d++;
+	if(x[i]=='.')        i++;while(i<n&&isdigit(x[i]))m=m*10+(x[i++]-'0'),d++,e--;
+	return (*len)=i,sign*(d<=15?m/p10[-e]: pjson_num(x+s,i-s)); // as pjson_num(), without scanning twice
 }
 double rnum(char*x,int n){int i=0;return rnum_len(x,n,&i);}
-void cswap(char*t,int a,int b){char v=t[a];t[a]=t[b],t[b]=v;}
-void crev(char*t,int n){int i=0,j=n-1;while(i<j)cswap(t,i++,j--);}
-void wnum(str*x,double y){
-	if(y<0)y=-y,str_addc(x,'-');char t[NUM*2]={0};int n=0,s=0;
-	t[n++]='0';double i=floor(y);y=round((y-floor(y))*1000000.0);if(y>=1000000)i++;
-	while(i>0){t[n++]=fmod(i,10)+'0',i=i/10;}crev(t+1,n-1);while(t[s]=='0'&&t[s+1])s++;t[n++]='.';
-	for(int z=0;z<6;z++){t[n+5-z]=fmod(y,10)+'0',y=y/10;}n+=5;while(n>0&&t[n]=='0')n--;if(t[n]=='.')n--;
-	str_add(x,t+s,n-s+1);
+void wnum(str*x,double y){ // up to 6 decimal places, without trailing zeroes. digits are written backwards from the end of t.
+	if(y<0)y=-y,str_addc(x,'-');char t[NUM*2];int n=sizeof(t);
+	double i=floor(y);unsigned int f=round((y-i)*1000000.0);if(f>=1000000)i++,f=0;
+	if(f){int d=6;while(f%10==0)f/=10,d--;while(d--)t[--n]=f%10+'0',f/=10;t[--n]='.';}
+	if(i<4294967296.0){unsigned int v=i;do t[--n]=v%10+'0',v/=10;while(v);} // exact, and much cheaper than fmod()
+	else{while(i>=1){t[--n]=fmod(i,10)+'0',i=i/10;}}
+	str_addn(x,t+n,sizeof(t)-n);
 }
 monad(l_rows);monad(l_cols);monad(l_range);monad(l_list);monad(l_first);
 dyad(l_dict);dyad(l_fuse);dyad(l_take);void dset(lv*d,lv*k,lv*x);
@@ -173,11 +277,41 @@ int matchr(lv*x,lv*y){
 void dsetuq(lv*d,lv*k,lv*x){
 	FIND(z,d,k){str s=str_new();str_addl(&s,k);str_addc(&s,'_');k=lmstr(s);break;}ld_add(d,k,x);
 }
-void dset(lv*d,lv*k,lv*x){FIND(z,d,k){d->lv[z]=x;return;}ld_add(d,k,x);}
+void dset(lv*d,lv*k,lv*x){FIND(z,d,k){d->lv[z]=lv_shade(x);return;}ld_add(d,k,x);}
 lv* dget(lv*d,lv*k){FIND(z,d,k)return d->lv[z];return NULL;}
 lv* dgetv(lv*d,lv*k){FIND(z,d,k)return d->lv[z];return NONE;}
 int dgeti(lv*d,lv*k){EACH(z,d)if(matchr(d->kv[z],k))return z;return -1;}
 lv* dkey(lv*d,lv*v){EACH(z,d)if(matchr(d->lv[z],v))return d->kv[z];return NONE;}
+unsigned int hash_bytes(unsigned int h,void*x,size_t n){unsigned char*b=x;for(size_t z=0;z<n;z++)h=(h^b[z])*16777619u;return h;}
+unsigned int lv_hash(lv*x){ // agrees with matchr(): values which match hash alike. never 0.
+	unsigned int h=2166136261u;
+	if(lin(x)){double v=x->nv==0?0:x->nv;h=hash_bytes(h,&v,sizeof(v));}
+	else if(lis(x)){for(int z=0;z<x->c&&x->sv[z];z++)h=(h^(0xFF&x->sv[z]))*16777619u;h=(h^x->c)*16777619u;}
+	else if(lil(x)){h=(h^x->t)*16777619u;EACH(z,x){unsigned int e=lv_hash(x->lv[z]);h=hash_bytes(h,&e,sizeof(e));}}
+	else if(lid(x)||lit(x)){
+		h=(h^x->t)*16777619u,h=(h^x->n)*16777619u;
+		EACH(z,x){unsigned int k=lv_hash(x->kv[z]),v=lv_hash(x->lv[z]);h=hash_bytes(h,&k,sizeof(k)),h=hash_bytes(h,&v,sizeof(v));}
+	}
+	else{h=hash_bytes(h,&x,sizeof(x));} // everything else only matches itself
+	return h?h:1;
+}
+int hix_slot(idx*h,lv**v,lv*k,unsigned int hk){ // slot holding k, or the empty slot where it belongs
+	int m=h->size-1,s=hk&m;while(h->iv[s]&&!matchr(v[h->iv[s]-1],k))s=(s+1)&m;return s;
+}
+void hix_build(idx*h,lv**v,int n){ // (re)index every value among v[0..n)
+	free(h->iv);h->size=16;while(h->size<n*2+2)h->size*=2;h->iv=calloc(h->size,sizeof(int));h->c=0;
+	for(int z=0;z<n;z++)h->iv[hix_slot(h,v,v[z],lv_hash(v[z]))]=z+1,h->c++;
+}
+int  hix_get(idx*h,lv**v,lv*k,unsigned int hk){int s=hix_slot(h,v,k,hk);TALLY((tel.finds++,tel.probes+=1+((s-hk)&(h->size-1))));return h->iv[s]-1;}
+void hix_put(idx*h,lv**v,int i,unsigned int hk){if((h->c+1)*2>h->size){hix_build(h,v,i+1);}else{h->iv[hix_slot(h,v,v[i],hk)]=i+1,h->c++;}}
+void dseth(lv*d,idx*h,lv*k,lv*x){ // dset() backed by a hash index over the keys of d, built once d grows
+	if(d->c<8&&!h->iv){dset(d,k,x);return;}
+	unsigned int hk=lv_hash(k);if(!h->iv)hix_build(h,d->kv,d->c);int i=hix_get(h,d->kv,k,hk);if(i>=0){d->lv[i]=lv_shade(x);return;}
+	ld_add(d,k,x),hix_put(h,d->kv,d->c-1,hk);
+}
+int dgeth(lv*d,idx*h,lv*k){ // dgeti() through the same index as dseth()
+	if(d->c<8&&!h->iv)return dgeti(d,k);if(!h->iv)hix_build(h,d->kv,d->c);return hix_get(h,d->kv,k,lv_hash(k));
+}
 lv* amend(lv*x,lv*i,lv*y){
 	if(lii(x))return ((lv*(*)(lv*,lv*,lv*))x->f)(x,i,y);
 	if(lit(x)&&lin(i)){
@@ -304,12 +438,11 @@ dyad(a_smax){lv*a=ls(x),*b=ls(y);return strcmp(a->sv,b->sv)>0?x:y;}
 dyad(a_max ){if(lin(x)||lin(y)){double a=ln(x),b=ln(y);return lmn(a>b?a:b);}return a_smax(x,y);}vd(max)
 dyad(l_unless){return lin(y)&&ln(y)==0?x:y;}
 dyad(l_match){return matchr(x,y)?ONE:NONE;}
-dyad(l_dict){x=ll(x);lv*r=lmd();y=ll(y);EACH(z,x)dset(r,x->lv[z],z>=y->c?NONE:y->lv[z]);return r;}
+dyad(l_dict){x=ll(x);lv*r=lmd();y=ll(y);idx h={0};EACH(z,x)dseth(r,&h,x->lv[z],z>=y->c?NONE:y->lv[z]);return free(h.iv),r;}
 dyad(l_split){
-	x=ls(x),y=ls(y);if(x->c==0)return ll(y);lv*r=lml(0);int n=0;EACH(z,y){
-		int m=1;EACH(w,x)if(x->sv[w]!=y->sv[z+w]){m=0;break;}if(!m)continue;
-		str s=str_new();str_add(&s,y->sv+n,z-n);ll_add(r,lmstr(s));z+=x->c-1,n=z+1;
-	}if(n<=y->c){str s=str_new();str_add(&s,y->sv+n,y->c-n);ll_add(r,lmstr(s));}return r;
+	x=ls(x),y=ls(y);if(x->c==0)return ll(y);lv*r=lml(0);int n=0,z;
+	while((z=str_find(y->sv+n,y->c-n,x->sv,x->c))>=0){str s=str_new();str_add(&s,y->sv+n,z);ll_add(r,lmstr(s));n+=z+x->c;}
+	str s=str_new();str_add(&s,y->sv+n,y->c-n);ll_add(r,lmstr(s));return r;
 }
 dyad(l_fuse){
 	str t=str_new();x=ls(x),y=ll(y);EACH(z,y){if(z)str_addl(&t,x);str_addl(&t,ls(y->lv[z]));}
@@ -317,7 +450,8 @@ dyad(l_fuse){
 }
 dyad(l_ina){
 	if(lil(y))EACH(z,y)if(matchr(y->lv[z],x))return ONE;
-	return lis(y)?(strstr(y->sv,ls(x)->sv)?ONE:NONE): (lid(y)||lit(y))&&dget(y,x)?ONE: NONE;
+	if(lis(y)){x=ls(x);return str_find(y->sv,y->c,x->sv,x->c)>=0?ONE:NONE;}
+	return (lid(y)||lit(y))&&dget(y,x)?ONE: NONE;
 }
 dyad(l_in){if(lil(x)){MAP(r,x)l_in(x->lv[z],y);return r;}return l_ina(x,y);}
 lv*filter(int in,lv*x,lv*y){
@@ -386,15 +520,15 @@ dyad(l_join){
 		if(i>=0){ll_add(ik,y->kv[z]);}else{ll_add(dk,lmn(z)),dset(r,y->kv[z],lml(0));}
 	}
 	#define join_key(t,r) lv*k;if(ik->c==1){k=dget(t,ik->lv[0])->lv[r];}else{k=lml(ik->c);EACH(z,ik)k->lv[z]=dget(t,ik->lv[z])->lv[r];}
-	lv*km=lmd();for(int bi=0;bi<y->n;bi++){
-		join_key(y,bi);lv*ix=dget(km,k);if(ix){ll_add(ix,lmn(bi));}else{dset(km,k,l_list(lmn(bi)));}
+	lv*km=lmd();idx h={0};for(int bi=0;bi<y->n;bi++){
+		join_key(y,bi);int i=dgeth(km,&h,k);if(i>=0){ll_add(km->lv[i],lmn(bi));}else{dseth(km,&h,k,l_list(lmn(bi)));}
 	}
 	for(int ai=0;ai<x->n;ai++){
-		join_key(x,ai);lv*ix=dget(km,k);if(ix)EACH(ii,ix){int bi=ln(ix->lv[ii]);
+		join_key(x,ai);int i=dgeth(km,&h,k);lv*ix=i>=0?km->lv[i]:NULL;if(ix)EACH(ii,ix){int bi=ln(ix->lv[ii]);
 			EACH(z,x )ll_add(r->lv[z     ],x->lv[z                   ]->lv[ai]);
 			EACH(z,dk)ll_add(r->lv[x->c+z],y->lv[(int)(dk->lv[z]->nv)]->lv[bi]);r->n++;
 		}
-	}return r;
+	}return free(h.iv),r;
 }
 monad(l_sum ){x=ll(x);lv*r=NONE      ;for(int z=0;z<x->c;z++)r=l_add  (r,x->lv[z]);return r;}
 monad(l_prod){x=ll(x);lv*r=ONE       ;for(int z=0;z<x->c;z++)r=l_mul  (r,x->lv[z]);return r;}
@@ -407,25 +541,41 @@ char esc(char e,int*i,char*t,int*n){
 	char h[5]={0};return e=='n'?'\n':strchr("\\\"/'",e)?e:
 	e=='u'&&*n>=4?(memcpy(h,t+*i,4),(*i)+=4,(*n)-=4,strtol(h,NULL,16)):' ';
 }
+#define jc()    (*n&&*f?t[*i]:0)
+#define jn()    (*n&&*f?(--*n,t[(*i)++]):0)
+#define jm(x)   jc()==x?(jn(),1):0
+#define js()    while(isspace(jc()))jn();
+#define jd()    while(isdigit(jc()))jn();
+#define jl(x,y) if((*n)>=(int)strlen(x)&&memcmp(t+*i,x,strlen(x))==0)return(*i)+=strlen(x),(*n)-=strlen(x),y;
+lv* pjson_str(char*t,int*i,int*f,int*n,char q){
+	str r=str_new();while(jc()&&!(jm(q))){
+		if(jm('\\')){str_addc(&r,esc(jn(),i,t,n));continue;}
+		int s=*i;while(*n&&((t[*i]>=32&&t[*i]<=126&&t[*i]!=q&&t[*i]!='\\')||t[*i]=='\n'))(*i)++,(*n)--; // copy plain runs in bulk
+		if(*i>s){str_addn(&r,t+s,*i-s);}else{str_addc(&r,jn());}
+	}return lmstr(r);
+}
 lv* pjson(char*t,int*i,int*f,int*n){
-	#define jc()    (*n&&*f?t[*i]:0)
-	#define jn()    (*n&&*f?(--*n,t[(*i)++]):0)
-	#define jm(x)   jc()==x?(jn(),1):0
-	#define js()    while(isspace(jc()))jn();
-	#define jd()    while(isdigit(jc()))jn();
-	#define jl(x,y) if((*n)>=(int)strlen(x)&&memcmp(t+*i,x,strlen(x))==0)return(*i)+=strlen(x),(*n)-=strlen(x),y;
 	jl("null",NONE);jl("false",NONE);jl("true",ONE);
 	if(jm('[')){lv*r=lml(0);while(jc()){js();if(jm(']'))break;ll_add(r,pjson(t,i,f,n));js();jm(',');}return r;}
-	if(jm('{')){lv*r=lmd( );while(jc()){js();if(jm('}'))break;lv*k=pjson(t,i,f,n);js();jm(':');js();if(*f)dset(r,k,pjson(t,i,f,n));js();jm(',');}return r;}
-	if(jm('"' )){str r=str_new();while(jc()&&!(jm('"' ))){str_addc(&r,(jm('\\'))?esc(jn(),i,t,n):jn());}return lmstr(r);}
-	if(jm('\'')){str r=str_new();while(jc()&&!(jm('\''))){str_addc(&r,(jm('\\'))?esc(jn(),i,t,n):jn());}return lmstr(r);}
+	if(jm('{')){
+		lv*r=lmd();idx h={0};while(jc()){js();if(jm('}'))break;lv*k=pjson(t,i,f,n);js();jm(':');js();if(*f)dseth(r,&h,k,pjson(t,i,f,n));js();jm(',');}
+		return free(h.iv),r;
+	}
+	if(jm('"' ))return pjson_str(t,i,f,n,'"' );
+	if(jm('\''))return pjson_str(t,i,f,n,'\'');
 	int ns=*i;jm('-');jd();jm('.');jd();if(jm('e')||jm('E')){jm('-')||jm('+');jd();}if(*i<=ns){*f=0;return NONE;}
-	char tb[NUM];snprintf(tb,MIN(*i-ns+1,NUM),"%s",t+ns);return lmn(atof(tb));
+	return lmn(pjson_num(t+ns,*i-ns));
 }
 lv* plove(char*t,int*i,int*f,int*n){
 	if(jm('[')){lv*r=lml(0);while(jc()){js();if(jm(']'))break;ll_add(r,plove(t,i,f,n));js();jm(',');}return r;}
-	if(jm('{')){lv*r=lmd( );while(jc()){js();if(jm('}'))break;lv*k=plove(t,i,f,n);js();jm(':');js();if(*f)dset(r,k,plove(t,i,f,n));js();jm(',');}return r;}
-	if(jm('<')){lv*r=lmd( );while(jc()){js();if(jm('>'))break;lv*k=plove(t,i,f,n);js();jm(':');js();if(*f)dset(r,ls(k),ll(plove(t,i,f,n)));js();jm(',');}return l_table(r);}
+	if(jm('{')){
+		lv*r=lmd();idx h={0};while(jc()){js();if(jm('}'))break;lv*k=plove(t,i,f,n);js();jm(':');js();if(*f)dseth(r,&h,k,plove(t,i,f,n));js();jm(',');}
+		return free(h.iv),r;
+	}
+	if(jm('<')){
+		lv*r=lmd();idx h={0};while(jc()){js();if(jm('>'))break;lv*k=plove(t,i,f,n);js();jm(':');js();if(*f)dseth(r,&h,ls(k),ll(plove(t,i,f,n)));js();jm(',');}
+		return free(h.iv),l_table(r);
+	}
 	if(jm('%')){jm('%');str r=str_new();str_addz(&r,"%%");while(jc()&&(isalnum(jc())||strchr("+/=",jc())))str_addc(&r,jn());return idecode(lmstr(r));}
 	return pjson(t,i,f,n);
 }
@@ -482,9 +632,9 @@ dyad(l_parse){
 			}if(!m)r.c=0;v=lmstr(r);
 		}
 		else if(t=='f'||t=='c'||t=='C'){
-			double r=0,p=10,s=hc=='-'?(h++,-1):1;if(t=='c'&&m&&hc=='$')h++;
-			m&=!!isdigit(hc)||hc=='.';while(hn&&isdigit(hc))r=r*10+hc-'0',h++;
-			if(hn&&hc=='.')h++;while(hn&&isdigit(hc))r+=(hc-'0')/p,p*=10,h++;v=lmn(r*s);
+			int s=hc=='-'?(h++,-1):1;if(t=='c'&&m&&hc=='$')h++;
+			m&=!!isdigit(hc)||hc=='.';int ds=h;while(hn&&isdigit(hc))h++;
+			if(hn&&hc=='.')h++;while(hn&&isdigit(hc))h++;v=lmn(s*pjson_num(y->sv+ds,h-ds));
 		}
 		else if(t=='e'||t=='p'){
 			struct tm tm={0};if(m){
@@ -500,14 +650,23 @@ dyad(l_parse){
 		else{m=0;}while(n&&hc&&h-si<n)h++,m=0;if(!sk&&v){named?dset(r,nk.sv?lmstr(nk):lmn(pi),v):ll_add(r,v);pi++;}
 	}return named?r: r->c==1?r->lv[0]:r;
 }
+int plain(char c,char*esc){return c>=32&&c<=126&&!strchr(esc,c);}
 void fjson(str*s,lv*x){
 	if(lin(x)){wnum(s,x->nv);}
-	else if(lit(x)){fjson(s,l_rows(x));}
+	else if(lit(x)){ // as fjson(s,l_rows(x)), without materializing a dict per row:
+		str_addc(s,'[');for(int r=0;r<x->n;r++){
+			if(r)str_addc(s,',');str_addc(s,'{');
+			EACH(z,x){if(z)str_addc(s,',');fjson(s,ls(x->kv[z]));str_addc(s,':');fjson(s,x->lv[z]->lv[r]);}str_addc(s,'}');
+		}str_addc(s,']');
+	}
 	#define wrap(a,b,c) str_addc(s,a);EACH(z,x)c;str_addc(s,b);
 	else if(lil(x)){wrap('[',']',{if(z)str_addc(s,',');fjson(s,x->lv[z]);})}
 	else if(lid(x)){wrap('{','}',{if(z)str_addc(s,',');fjson(s,ls(x->kv[z]));str_addc(s,':');fjson(s,x->lv[z]);})}
 	else if(lis(x)){
-		str_addc(s,'"');int ct=0;EACH(z,x){
+		str_addc(s,'"');int ct=0;for(int z=0;z<x->c;z++){
+			int r=z;while(r<x->c&&plain(x->sv[r],"\"\\</"))r++;if(r>z){ // bulk-copy runs needing no escapes
+				if(ct&&(int)strspn(x->sv+z," ")<r-z)ct=0;str_addn(s,x->sv+z,r-z);z=r;if(z>=x->c)break;
+			}
 			char c=x->sv[z],e=0;if(c=='<'){ct=1;}else if(c=='/'&&ct){e=1;}else if(c!=' '&&c!='\n'){ct=0;}
 			if(c=='\n'?(c='n',1):e||!!strchr("\"\\",c))str_addc(s,'\\');str_addc(s,c);
 		}str_addc(s,'"');
@@ -521,6 +680,13 @@ void flove(str*s,lv*x){
 	else if(lii(x)){str_addl(s,ls(((lv*(*)(lv*,lv*,lv*))x->f)(x,lmistr("encoded"),NULL)));}
 	else{str_addz(s,"null");}
 }
+struct tm* utc_time(time_t*t,struct tm*r){ // gmtime() returns a buffer shared by every thread, except on windows
+	#ifdef _WIN32
+	*r=*gmtime(t);return r;
+	#else
+	return gmtime_r(t,r);
+	#endif
+}
 void format_type(str*r,lv*a,char t,int n,int d,int lf,int pz,int*f,char*c){
 	char o[NUM]={0},*op=o;
 	if     (t=='%')snprintf(o,NUM,"%%");
@@ -537,7 +703,7 @@ void format_type(str*r,lv*a,char t,int n,int d,int lf,int pz,int*f,char*c){
 	else if(t=='j'){str v=str_new();fjson(&v,a    );op=lmstr(v)->sv;}
 	else if(t=='J'){str v=str_new();flove(&v,a    );op=lmstr(v)->sv;}
 	else if(t=='q'){str v=str_new();fjson(&v,ls(a));op=lmstr(v)->sv;}
-	else if(t=='e'){time_t v=ln(a);strftime(o,NUM,"%FT%TZ",gmtime(&v));}
+	else if(t=='e'){time_t v=ln(a);struct tm u;strftime(o,NUM,"%FT%TZ",utc_time(&v,&u));}
 	else if(t=='p'){
 		struct tm v={0};lv*d=ld(a);
 		#define pg(x,f,o) {lv*p=dget(d,lmcstr(x));v.tm_##f=p?ln(p)-o:0;}
@@ -546,7 +712,7 @@ void format_type(str*r,lv*a,char t,int n,int d,int lf,int pz,int*f,char*c){
 	}
 	int vn=strlen(op); if(d&&strchr("fcC",t))d=0; if(d&&lf)vn=MIN(d,vn);
 	if(n&&!lf)for(int z=0;z<n-vn;z++)str_addc(r,pz?'0':' ');
-	for(int z=d&&!lf?MAX(0,vn-d):0;z<vn;z++)str_addc(r,ulc(op[z]));
+	int st=d&&!lf?MAX(0,vn-d):0;if(t!='l'&&t!='u'){str_addr(r,op+st,vn-st);}else{for(int z=st;z<vn;z++)str_addc(r,ulc(op[z]));}
 	if(n&&lf)for(int z=0;z<n-vn;z++)str_addc(r,pz?'0':' ');
 }
 void format_type_simple(str*r,lv*value,char t){int f=0;format_type(r,value,t,0,0,0,0,&f,"");}
@@ -559,7 +725,7 @@ lv* format_rec(int i,lv*x,lv*y){
 dyad(l_format){
 	if(lil(x))return format_rec(0,x,y);
 	str r=str_new();x=ls(x);int f=0,h=0,named=format_has_names(x);y=named?ld(y):lil(y)?y:l_list(y);while(fc){
-		if(fc!='%'){str_addc(&r,fc),f++;continue;}f++;
+		if(fc!='%'){int e=f;while(x->sv[e]&&x->sv[e]!='%')e++;str_addr(&r,x->sv+f,e-f),f=e;continue;}f++;
 		str nk={0};if(fc=='['){f++;nk=str_new();while(fc&&fc!=']')str_addc(&nk,fc),f++;if(fc==']')f++;}
 		int n=0,d=0,sk=fc=='*'&&(f++,1),lf=fc=='-'&&(f++,1),pz=fc=='0'&&(f++,1);
 		while(isdigit(fc))n=n*10+fc-'0',f++;if(fc=='.')f++;
@@ -611,12 +777,12 @@ lv* l_tab(lv*t){
 	return r;
 }
 lv* merge(lv*vals,lv*keys,int widen,lv**ix){
-	lv*i=lmistr("@index");
-	if(!widen){*ix=lml(0);EACH(z,vals){lv*x=dget(vals->lv[z],i);EACH(z,x)ll_add(*ix,x->lv[z]);}}
+	lv*i=lmistr("@index");vals=ll(vals);EACH(z,vals)if(!lid(vals->lv[z])||!dget(vals->lv[z],i))return *ix=lml(0),lmt(); // only from malformed bytecode
+	if(!widen){*ix=lml(0);EACH(z,vals){lv*x=ll(dget(vals->lv[z],i));EACH(z,x)ll_add(*ix,x->lv[z]);}}
 	if(widen){lv*t=lml(0);EACH(z,vals)if(dget(vals->lv[z],i)->c)ll_add(t,vals->lv[z]);vals=t;}
 	if(vals->c==0){lv*d=lmd();EACH(z,keys)dset(d,keys->lv[z],lml(0));ll_add(vals,d);}
 	GEN(r,vals->c)l_table(widen?vals->lv[z]:l_drop(i,vals->lv[z]));r=l_raze(r);
-	if(widen){*ix=dget(r,i);r=l_drop(i,r);}return r;
+	if(widen){*ix=dget(r,i);if(!*ix)*ix=lml(0);r=l_drop(i,r);}return r;
 }
 lv* disclose(lv*x){lv*t=lml(3);t->lv[0]=lmistr("index"),t->lv[1]=lmistr("gindex"),t->lv[2]=lmistr("group");return l_drop(t,x);}
 lv* l_select(lv*orig,lv*vals,lv*keys){lv*ix=NULL,*r=merge(vals,keys,0,&ix);return keys->c>1?r:l_take(ix,disclose(orig));}
@@ -636,14 +802,14 @@ lv* l_where(lv*col,lv*tab){
 	lv*r=l_take(p,tab);dset(r,lmistr("gindex"),l_range(lmn(r->n)));return r;
 }
 lv* l_by(lv*col,lv*tab){
-	lv*b=l_take(lmn(tab->n),ll(col)),*u=lmd(),*gi=lmistr("gindex"),*gr=lmistr("group");
+	lv*b=l_take(lmn(tab->n),ll(col)),*u=lmd(),*gi=lmistr("gindex"),*gr=lmistr("group");idx h={0};
 	EACH(row,b){
-		int ki=dgeti(u,b->lv[row]);if(ki==-1){TMAP(nt,tab,lml(0));ki=u->c,dset(u,b->lv[row],nt);}
+		int ki=dgeth(u,&h,b->lv[row]);if(ki==-1){TMAP(nt,tab,lml(0));ki=u->c,dseth(u,&h,b->lv[row],nt);}
 		lv*t=u->lv[ki];EACH(col,tab)ll_add(t->lv[col],tab->lv[col]->lv[row]);
 		dget(t,gi)->lv[t->n]=lmn(t->n);dget(t,gr)->lv[t->n]=lmn(ki);t->n++;
-	}return ll(u);
+	}return free(h.iv),ll(u);
 }
-lv*order_vec=NULL;int order_dir=0; // this is gross. qsort() is badly designed, and qsort_r is unportable.
+LIL_LOCAL lv*order_vec=NULL;LIL_LOCAL int order_dir=0; // this is gross. qsort() is badly designed, and qsort_r is unportable.
 int lex_less(lv*a,lv*b);int lex_more(lv*a,lv*b);// forward refs
 int lex_list(lv*x,lv*y,int a,int ix){
 	if(x->c<ix&&y->c<ix)return 0;lv*xv=x->c>ix?x->lv[ix]:NONE,*yv=y->c>ix?y->lv[ix]:NONE;
@@ -690,22 +856,35 @@ primitive triads[]={
 // Bytecode
 
 int findop(char*n,primitive*p){if(n)for(int z=0;p[z].name[0];z++)if(!strcmp(n,p[z].name))return z;return -1;}
-int tnames=0;lv* tempname(void){char t[64];snprintf(t,sizeof(t),"@t%d",tnames++);return lmcstr(t);}
-enum opcodes {JUMP,JUMPF,LIT,DUP,DROP,SWAP,OVER,BUND,OP1,OP2,OP3,GET,SET,LOC,AMEND,TAIL,CALL,BIND,ITER,EACH,NEXT,COL,IPRE,IPOST,FIDX,FMAP};
-int oplens[]={3   ,3    ,3  ,1  ,1   ,1   ,1   ,3   ,3  ,3  ,3  ,3  ,3  ,3  ,3    ,1   ,1   ,1   ,1   ,3   ,3   ,1  ,3   ,3    ,3   ,3   };
+LIL_LOCAL int tnames=0;lv* tempname(void){char t[64];snprintf(t,sizeof(t),"@t%d",tnames++);return lmcstr(t);}
+enum opcodes {JUMP,JUMPF,LIT,DUP,DROP,SWAP,OVER,BUND,OP1,OP2,OP3,GET,SET,LOC,AMEND,TAIL,CALL,BIND,ITER,EACH,NEXT,COL,IPRE,IPOST,FIDX,FMAP,RANGE};
+char*opnames[]={"jump","jumpf","lit","dup","drop","swap","over","bund","op1","op2","op3","get","set","loc","amend","tail","call","bind","iter","each","next","col","ipre","ipost","fidx","fmap","range",""};
+int oplens[]={5   ,5    ,5  ,1  ,1   ,1   ,1   ,5   ,5  ,5  ,5  ,5  ,5  ,5  ,5    ,1   ,1   ,1   ,1   ,5   ,5   ,1  ,5   ,5    ,5   ,5   ,5    };
+// blocks may carry a name (a) and a line table (b): (offset,row) int pairs, appended as the source row changes.
+LIL_LOCAL int blk_prow=-1,blk_rowo=-1; // the row of the token being parsed (if any), and an override for blk_cat()
+void blk_row(lv*x,int o,int row){
+	lv*t=x->b;if(row<0||(t&&((int*)t->sv)[t->c/sizeof(int)-1]==row))return;if(!t)t=x->b=lv_shade(lms(0));
+	t->sv=realloc(t->sv,t->c+2*sizeof(int)+1);int*v=(int*)(t->sv+t->c);v[0]=o,v[1]=row,t->c+=2*sizeof(int);
+}
+int blk_rowat(lv*x,int o){int r=-1;lv*t=x->b;if(t&&lis(t))for(int z=0;z<t->c/(int)sizeof(int);z+=2){int*v=(int*)t->sv+z;if(v[0]>o)break;r=v[1];}return r;}
 void blk_addb(lv*x,int n){
+	blk_row(x,x->n,blk_rowo>=0?blk_rowo:blk_prow);
 	if(x->ns<x->n+1)x->sv=realloc(x->sv,(x->ns*=2)*sizeof(int));x->sv[x->n++]=n;
-	if(x->n>=65536||x->c>=65536)printf("TOO MUCH BYTECODE!\n"),exit(1);
 }
 int  blk_here(lv*x){return x->n;}
 void blk_setb(lv*x,int i,int n){x->sv[i]=n&0xFF;}
 int  blk_getb(lv*x,int i){return 0xFF&(x->sv[i]);}
-void blk_adds(lv*x,int n){blk_addb(x,0xFF&(n>>8)),blk_addb(x,0xFF&n);}
-void blk_sets(lv*x,int i,int n){blk_setb(x,i,n>>8),blk_setb(x,i+1,n);}
-int  blk_gets(lv*x,int i){return 0xFFFF&(blk_getb(x,i)<<8|blk_getb(x,i+1));}
+void blk_addi(lv*x,int n){for(int z=24;z>=0;z-=8)blk_addb(x,0xFF&(n>>z));} // operands are 32-bit, big-endian
+void blk_seti(lv*x,int i,int n){for(int z=0;z<4;z++)blk_setb(x,i+z,n>>(24-8*z));}
+int  blk_geti(lv*x,int i){unsigned char*p=(unsigned char*)x->sv+i;return (int)((unsigned)p[0]<<24|p[1]<<16|p[2]<<8|p[3]);}
 void blk_op  (lv*x,int o){blk_addb(x,o);if(o==COL)blk_addb(x,SWAP);}
-int  blk_opa (lv*x,int o,int i){blk_addb(x,o),blk_adds(x,i);return blk_here(x)-2;}
-void blk_imm (lv*x,int o,lv*k){int i=-1;EACH(z,x)if(matchr(x->lv[z],k))i=z;if(i==-1)i=x->c,ll_add(x,k);blk_opa(x,o,i);}
+int  blk_opa (lv*x,int o,int i){blk_addb(x,o),blk_addi(x,i);return blk_here(x)-4;}
+void blk_imm (lv*x,int o,lv*k){ // constants are pooled; once there are a few, they are found through an index kept in x->f
+	idx*h=x->f;int i=-1;unsigned int hk=0;
+	if(x->c<8&&!h){EACH(z,x)if(matchr(x->lv[z],k))i=z;}
+	else{hk=lv_hash(k);if(!h)h=x->f=calloc(1,sizeof(idx)),hix_build(h,x->lv,x->c);i=hix_get(h,x->lv,k,hk);}
+	if(i==-1){i=x->c,ll_add(x,k);if(h)hix_put(h,x->lv,i,hk);}blk_opa(x,o,i);
+}
 #define blk_op1(x,n) blk_opa(x,OP1,findop(n,monads))
 #define blk_op2(x,n) blk_opa(x,OP2,findop(n,dyads ))
 #define blk_op3(x,n) blk_opa(x,OP3,findop(n,triads))
@@ -715,22 +894,34 @@ void blk_imm (lv*x,int o,lv*k){int i=-1;EACH(z,x)if(matchr(x->lv[z],k))i=z;if(i=
 #define blk_get(x,n)    blk_imm(x,GET,n)
 lv*  blk_getimm(lv*x,int i){return x->lv[i];}
 void blk_cat(lv*x,lv*y){
-	int z=0,base=blk_here(x);while(z<blk_here(y)){
-		int b=blk_getb(y,z);if(b==LIT||b==GET||b==SET||b==LOC||b==AMEND){blk_imm(x,b,blk_getimm(y,blk_gets(y,z+1)));}
-		else if(b==JUMP||b==JUMPF||b==EACH||b==NEXT||b==FIDX){blk_opa(x,b,blk_gets(y,z+1)+base);}
+	int z=0,base=blk_here(x),o=blk_rowo;while(z<blk_here(y)){
+		int b=blk_getb(y,z);blk_rowo=blk_rowat(y,z);if(b==LIT||b==GET||b==SET||b==LOC||b==AMEND){blk_imm(x,b,blk_getimm(y,blk_geti(y,z+1)));}
+		else if(b==JUMP||b==JUMPF||b==EACH||b==NEXT||b==FIDX){blk_opa(x,b,blk_geti(y,z+1)+base);}
 		else{for(int i=0;i<oplens[b];i++)blk_addb(x,blk_getb(y,z+i));}z+=oplens[b];
-	}
-}
-void blk_loop(lv*b,lv*names,lv*body){
-	blk_op(b,ITER);int head=blk_here(b);blk_lit(b,names);int each=blk_opa(b,EACH,0);
-	blk_cat(b,body),blk_opa(b,NEXT,head),blk_sets(b,each,blk_here(b));
+	}blk_rowo=o;
+}
+void blk_each(lv*b,lv*names,lv*body){
+	int head=blk_here(b);blk_lit(b,names);int each=blk_opa(b,EACH,0);
+	blk_cat(b,body),blk_opa(b,NEXT,head),blk_seti(b,each,blk_here(b));
+}
+void blk_loop(lv*b,lv*names,lv*body){blk_op(b,ITER),blk_each(b,names,body);}
+void blk_trim(lv*x,int n){lv*t=x->b;x->n=n;while(t&&t->c&&((int*)t->sv)[t->c/sizeof(int)-2]>=n)t->c-=2*sizeof(int);}
+int blk_range(lv*b,int s){
+	// an each loop over "range y", "x take range y" or "x drop range y" (the code from s onwards) doesn't need that list:
+	// RANGE stands in for the operators and ITER, and numbers the elements as the loop visits them. no path may join
+	// the code after the range, such as the arms of an "if" which end the source expression.
+	int n=blk_here(b),p=-1,q=-1,o,m=0;for(int z=s;z<n;z+=oplens[blk_getb(b,z)])q=p,p=z;if(p<0)return 0;
+	if(blk_getb(b,p)==OP2){int i=blk_geti(b,p+1);m=i==findop("take",dyads)?1: i==findop("drop",dyads)?2: 0;if(!m||q<0)return 0;p=q;}
+	if(blk_getb(b,p)!=OP1||blk_geti(b,p+1)!=findop("range",monads))return 0;
+	for(int z=s;z<n;z+=oplens[o]){o=blk_getb(b,z);if((o==JUMP||o==JUMPF||o==EACH||o==NEXT||o==FIDX)&&blk_geti(b,z+1)>p)return 0;}
+	blk_trim(b,p),blk_opa(b,RANGE,m);return 1;
 }
 lv* blk_end(lv*x){
 	int z=0;while(z<blk_here(x)){
 		int b=blk_getb(x,z);z+=oplens[b];if(b!=CALL)continue;
 		int t=1,i=z;while(i<blk_here(x)){
 			if(blk_getb(x,i)!=JUMP){t=0;break;}
-			int a=blk_gets(x,i+1);if(a<=i){t=0;break;}i=a;
+			int a=blk_geti(x,i+1);if(a<=i){t=0;break;}i=a;
 		}if(t)blk_setb(x,z-1,TAIL);
 	}return x;
 }
@@ -738,7 +929,7 @@ lv* blk_end(lv*x){
 // Parser
 
 typedef struct{int row,col,a,b;char type;double nv;}token;
-typedef struct{int i,r,c,tl;char*text;token here,next;char error[1024];}parser;parser par;
+typedef struct{int i,r,c,tl;char*text;token here,next;char error[1024];}parser;LIL_LOCAL parser par;
 #define init_tok(x,v) (x->type=v,x->row=par.r,x->col=par.c)
 #define perr()        par.error[0]
 //         ! "#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\]^_`abcdefghijklmnopqrstuvwxyz{|}~
@@ -793,10 +984,10 @@ str literal_str(token*t){
 }
 token* next(void){
 	if(par.next.type){par.here=par.next;par.next.type=0;}else{tok(&par.here);}
-	return &par.here;
+	blk_prow=par.here.row;return &par.here;
 }
 token* peek(void){if(!par.next.type)tok(&par.next);return &par.next;}
-token peek2(void){parser t=par;next();token r=*peek();par=t;return r;}
+token peek2(void){parser t=par;int o=blk_prow;next();token r=*peek();par=t,blk_prow=o;return r;}
 int hasnext(void){return !perr()&&((par.next.type&&par.next.type!='e')||peek()->type!='e');}
 int matchsp(char x){return perr()?0: peek()->type==x?(next(),1):0;}
 int matchp(char*x){
@@ -897,29 +1088,29 @@ void term(lv*b){
 			if(fi>=4096){snprintf(par.error,sizeof(par.error),"Too many elseif clauses.");return;}
 			if(match("elseif")){
 				if(e){snprintf(par.error,sizeof(par.error),"Expected 'end'.");return;}
-				if(!c)blk_lit(b,NONE);c=0;fin[fi++]=blk_opa(b,JUMP,0);blk_sets(b,next,blk_here(b));expr(b);next=blk_opa(b,JUMPF,0);continue;
+				if(!c)blk_lit(b,NONE);c=0;fin[fi++]=blk_opa(b,JUMP,0);blk_seti(b,next,blk_here(b));expr(b);next=blk_opa(b,JUMPF,0);continue;
 			}
 			if(match("else")){
 				if(e){snprintf(par.error,sizeof(par.error),"Expected 'end'.");return;}
-				if(!c)blk_lit(b,NONE);c=0,e=1;fin[fi++]=blk_opa(b,JUMP,0);blk_sets(b,next,blk_here(b)),next=-1;continue;
+				if(!c)blk_lit(b,NONE);c=0,e=1;fin[fi++]=blk_opa(b,JUMP,0);blk_seti(b,next,blk_here(b)),next=-1;continue;
 			}
 			if(match("end")){
-				if(!c)blk_lit(b,NONE);c=0;if(!e)fin[fi++]=blk_opa(b,JUMP,0);if(next!=-1)blk_sets(b,next,blk_here(b));if(!e)blk_lit(b,NONE);
-				for(int z=0;z<fi;z++)blk_sets(b,fin[z],blk_here(b));return;
+				if(!c)blk_lit(b,NONE);c=0;if(!e)fin[fi++]=blk_opa(b,JUMP,0);if(next!=-1)blk_seti(b,next,blk_here(b));if(!e)blk_lit(b,NONE);
+				for(int z=0;z<fi;z++)blk_seti(b,fin[z],blk_here(b));return;
 			}
 			if(c)blk_op(b,DROP);expr(b),c++;
 		}
 	}
 	if(match("while")){
 		blk_lit(b,NONE);int head=blk_here(b);expr(b);int cond=blk_opa(b,JUMPF,0);
-		blk_op(b,DROP);iblock(b);blk_opa(b,JUMP,head);blk_sets(b,cond,blk_here(b));return;
+		blk_op(b,DROP);iblock(b);blk_opa(b,JUMP,head);blk_seti(b,cond,blk_here(b));return;
 	}
-	if(match("each")){lv*n=names("in","variable");expr(b),blk_loop(b,n,block());return;}
+	if(match("each")){lv*n=names("in","variable");int s=blk_here(b);expr(b);if(!blk_range(b,s))blk_op(b,ITER);blk_each(b,n,block());return;}
 	if(match("on")){
 		str n=name("function");int var=matchsp('.')&&matchsp('.')&&matchsp('.');lv*a=names("do","argument");
 		if(!perr()&&var&&a->c!=1){snprintf(par.error,sizeof(par.error),"Variadic functions must take exactly one named argument.");return;}
 		if(var&&a->c==1)a=l_list(l_format(lmistr("...%s"),l_first(a)));
-		blk_lit(b,lmon(n,a,blk_end(block())));blk_op(b,BIND);return;
+		lv*body=blk_end(block());body->a=lmcstr(n.sv);blk_lit(b,lmon(n,a,body));blk_op(b,BIND);return;
 	}
 	if(match("send")){
 		blk_lit(b,lmnat(n_uplevel,NULL)),blk_lit(b,lmstr(name("function"))),blk_op(b,CALL);
@@ -955,7 +1146,7 @@ void expr(lv*b){
 		lv*func=tempname();blk_set(b,func);blk_op(b,DROP);expr(b);
 		lv*l=lmblk();blk_get(l,func),blk_op(l,SWAP);int fidx=blk_opa(l,FIDX,0);
 		lv*ll=lmblk();blk_get(ll,func);blk_get(ll,lmistr("v"));blk_opa(ll,BUND,1);blk_op(ll,CALL);
-		blk_loop(l,l_list(lmistr("v")),ll);blk_sets(l,fidx,blk_here(l));
+		blk_loop(l,l_list(lmistr("v")),ll);blk_seti(l,fidx,blk_here(l));
 		while(depth-->0){lv*t=tempname(),*m=lmblk(),*n=lmblk();blk_get(n,t),blk_cat(n,l),blk_loop(m,l_list(t),n);l=m;}
 		blk_cat(b,l);return;
 	}
@@ -963,17 +1154,20 @@ void expr(lv*b){
 }
 lv* parse(char*text){
 	par=(parser){0,0,0,strlen(text),text,{0},{0},"\0"};
-	lv*b=lmblk();if(hasnext())expr(b);while(hasnext())blk_op(b,DROP),expr(b);
-	if(blk_here(b)==0)blk_lit(b,NONE);return b;
+	lv*b=lmblk();blk_prow=0;if(hasnext())expr(b);while(hasnext())blk_op(b,DROP),expr(b);
+	if(blk_here(b)==0)blk_lit(b,NONE);blk_prow=-1;return b;
 }
 
 // Interpreter
 
-void env_local(lv*e,lv*n,lv*x){SFIND(z,e,n->sv){e->lv[z]=x;return;}ld_add(e,n,x);}
-lv* env_getr(lv*e,lv*n){SFIND(z,e,n->sv)return e->lv[z];return e->env?env_getr(e->env,n): NULL;}
-void env_setr(lv*e,lv*n,lv*x){SFIND(z,e,n->sv){e->lv[z]=x;return;}if(e->env)env_setr(e->env,n,x);}
-lv* env_get(lv*e,lv*n){lv*r=env_getr(e,n);return r?r:NONE;}
-void env_set(lv*e,lv*n,lv*x){lv*r=env_getr(e,n);r?env_setr(e,n,x):env_local(e,n,x);}
+void env_local(lv*e,lv*n,lv*x){SFIND(z,e,n->sv){e->lv[z]=lv_shade(x);return;}ld_add(e,n,x);}
+lv** env_slot(lv*e,lv*n){ // where the variable n is bound, in e or an enclosing scope, if anywhere
+	int h=0;lv**r=NULL;for(;e&&!r;e=e->env){h++;SFIND(z,e,n->sv){r=&e->lv[z];break;}}
+	TALLY((tel.lookups++,tel.hops+=h,tel.maxhops=MAX(tel.maxhops,h)));return r;
+}
+lv* env_find(lv*e,lv*n){lv**r=env_slot(e,n);return r?*r:NULL;}
+lv* env_get(lv*e,lv*n){lv*r=env_find(e,n);return r?r:NONE;}
+void env_set(lv*e,lv*n,lv*x){lv**r=env_slot(e,n);if(r&&*r){*r=lv_shade(x);}else{env_local(e,n,x);}}
 lv* env_bind(lv*e,lv*k,lv*v){lv*r=lmenv(e);EACH(z,k)env_local(r,k->lv[z],z<v->c?v->lv[z]:NONE);return r;}
 #define running()      (state.t->c)
 #define ev()           (state.e->lv[state.e->c-1])
@@ -991,9 +1185,29 @@ void docall(lv*f,lv*a,int tail){
 	issue(f->c==1&&f->lv[0]->sv[0]=='.'?env_bind(f->env,l_list(lmcstr(f->lv[0]->sv+3)),l_list(a)) :env_bind(f->env,f,a),f->b);
 	gc.depth=MAX(gc.depth,state.e->c);
 }
+lv* range_source(int m,lv*x,lv*y){
+	// the elements of range y, x take range y or x drop range y (m=0,1,2), for RANGE. while the counts are numbers,
+	// this is a list without storage: c elements, the z-th of which is nv+z modulo n (or z itself, if n is -1).
+	if(!lin(y)||(x&&!lin(x))){lv*r=l_range(y);return m==1?l_take(x,r): m==2?l_drop(x,r): r;}
+	int n=MAX(0,ln(y)),k=x?ln(x):0,s=0,c=n;
+	if(m==1)c=abs(k),s=k<0?mod(k,n):0;if(m==2)s=k>0?MIN(k,n):0,c=MAX(0,k>0?n-k:n+k);
+	lv*r=lmv(2);r->c=c,r->n=m?n:-1,r->nv=s;return r;
+}
+#ifndef LIL_NO_FASTOPS
+// the first few monads and dyads (in the order of monads[] and dyads[]) applied to plain numbers, without going through
+// perfuse() or conform(). these must agree exactly with a_negate() and friends. define LIL_NO_FASTOPS to leave them out.
+lv* fast_op1(int op,double a){return lmn(op==0?-a: op==1?a==0: floor(a));}
+lv* fast_op2(int op,double a,double b){
+	switch(op){
+		case 0:return lmn(a+b);        case 1:return lmn(a-b);        case 2:return lmn(a*b);   case 3:return lmn(b==0?0:a/b);
+		case 4:return lmn(dmod(b,a));  case 5:return lmn(pow(a,b));   case 6:return lmn(a<b);   case 7:return lmn(a>b);
+		case 8:return lmn(a==b);       case 9:return lmn(a<b?a:b);    default:return lmn(a>b?a:b);
+	}
+}
+#endif
 void runop(void){
-	lv*b=getblock();
-	int*pc=getpc(),op=blk_getb(b,*pc),imm=(oplens[op]==3?blk_gets(b,1+*pc):0);(*pc)+=oplens[op];
+	lv*b=getblock();gc.ops++;
+	int*pc=getpc(),op=blk_getb(b,*pc),imm=(oplens[op]>1?blk_geti(b,1+*pc):0);(*pc)+=oplens[op];TALLY(tel.ops[op]++);
 	switch(op){
 		case DROP:arg();break;
 		case DUP:{lv*a=arg();ret(a),ret(a);break;}
@@ -1006,8 +1220,13 @@ void runop(void){
 		case SET:{lv*v=arg();env_set(ev(),blk_getimm(b,imm),v);ret(v);break;}
 		case LOC:{lv*v=arg();env_local(ev(),blk_getimm(b,imm),v);ret(v);break;}
 		case BUND:{lv*r=lml(imm);EACHR(z,r)r->lv[z]=arg();ret(r);break;}
+		#ifndef LIL_NO_FASTOPS
+		case OP1:{lv*x=arg();ret(lin(x)&&imm<=2?fast_op1(imm,x->nv): ((lv*(*)(lv*))monads[imm].func)(x));break;}
+		case OP2:{lv*y=arg(),*x=arg();ret(lin(x)&&lin(y)&&imm<=10?fast_op2(imm,x->nv,y->nv): ((lv*(*)(lv*,lv*))dyads[imm].func)(x,y));break;}
+		#else
 		case OP1:{                      ret(((lv*(*)(lv*        ))monads[imm].func)(arg()    ));break;}
 		case OP2:{           lv*y=arg();ret(((lv*(*)(lv*,lv*    ))dyads [imm].func)(arg(),y  ));break;}
+		#endif
 		case OP3:{lv*z=arg();lv*y=arg();ret(((lv*(*)(lv*,lv*,lv*))triads[imm].func)(arg(),y,z));break;}
 		case IPRE:{lv*s=arg(),*i=arg();ret(i);docall(s,i->lv[imm],0);if(lion(s)||lii(s)||linat(s)){for(int z=0;z<=imm;z++)i->lv[z]=NULL;}break;}
 		case IPOST:{lv*s=arg(),*i=arg(),*r=arg();ret(i->lv[imm]?r:s),ret(i),ret(s);break;}
@@ -1027,17 +1246,19 @@ void runop(void){
 			lv*x=arg();lv*(*f)(lv*)=(lv*(*)(lv*))monads[imm].func;
 			if(lid(x)){DMAP(r,x,f(x->lv[z]));ret(r);}else{x=ll(x);MAP(r,x)f(x->lv[z]);ret(r);}break;
 		}
+		case RANGE:{lv*y=arg(),*x=imm?arg():NULL;ret(range_source(imm,x,y)),ret(lml(0));break;}
 		case EACH:{
 			lv*n=arg(),*r=arg(),*s=arg();if(r->c==s->c){*pc=imm,ret(r);break;}
-			int z=r->c;lv*v=lml(3);v->lv[0]=s->lv[z],v->lv[1]=lid(s)?s->kv[z]:lmn(z),v->lv[2]=lmn(z);
-			ll_add(state.e,env_bind(ev(),n,v)),ret(s),ret(r);break;
+			int z=r->c;lv*v[3],*e=lmenv(ev());v[2]=lmn(z),v[1]=lid(s)?s->kv[z]:v[2];
+			v[0]=s->lv?s->lv[z]: s->n==-1?v[2]: lmn(mod((int)s->nv+z,s->n));
+			EACH(k,n)env_local(e,n->lv[k],k<3?v[k]:NONE);ll_add(state.e,e),ret(s),ret(r);break;
 		}
 		case NEXT:{
 			lv*v=arg(),*r=arg(),*s=arg();ll_pop(state.e);
 			if(lid(r)){ld_add(r,s->kv[r->c],v);}else{ll_add(r,v);}ret(s),ret(r),*pc=imm;break;
 		}
 		case COL:{
-			lv*ex=arg(),*t=arg();ret(t);
+			lv*ex=arg(),*t=lt(arg());ret(t);
 			GEN(n,t->c)t->kv[z];GEN(v,t->c)t->lv[z];ll_add(n,lmistr("column")),ll_add(v,t);
 			issue(env_bind(ev(),n,v),ex);break;
 		}
@@ -1060,7 +1281,67 @@ lv*n_eval(lv*self,lv*a){
 	blk_opa(prog,BUND,2),blk_lit(prog,lmnat(n_feval,NULL)),blk_op(prog,SWAP),blk_op(prog,CALL);
 	issue(env_bind(a->c>2&&lb(a->lv[2])?ev():NULL,k,v),prog);return r;
 }
+// memo[f n] wraps f in a native with a cache of up to n results, keyed by argument lists and evicted least-recently-used first.
+// the cache is a list m: m->a is f, m->kv and m->lv hold the keys and results of the m->c slots in use (with room for m->s,
+// growing up to the limit m->n), and m->f holds a memo_state (freed by lv_free()), whose hash chains and recency links are indices into those slots.
+typedef struct{int hits,misses,count,head,tail,buckets;int*chain,*prev,*next,*bucket;unsigned int*hash;}memo_state;
+void memo_unlink(memo_state*s,int i){
+	if(s->prev[i]>=0)s->next[s->prev[i]]=s->next[i];else s->head=s->next[i];
+	if(s->next[i]>=0)s->prev[s->next[i]]=s->prev[i];else s->tail=s->prev[i];
+}
+void memo_front(memo_state*s,int i){s->prev[i]=-1,s->next[i]=s->head;if(s->head>=0)s->prev[s->head]=i;s->head=i;if(s->tail<0)s->tail=i;}
+int memo_find(lv*m,lv*a,unsigned int hk){
+	memo_state*s=(memo_state*)m->f;int i=s->bucket[hk&(s->buckets-1)];
+	while(i>=0&&(s->hash[i]!=hk||!matchr(m->kv[i],a)))i=s->chain[i];return i;
+}
+int  memo_buckets(int n){int nb=16;while(nb<n)nb*=2;return nb;}
+long memo_bytes(int n){return sizeof(memo_state)+(3*n+memo_buckets(n))*sizeof(int)+n*sizeof(unsigned int);} // for n slots
+memo_state* memo_alloc(int n){
+	int nb=memo_buckets(n);memo_state*s=calloc(1,memo_bytes(n));
+	s->chain=(int*)(s+1),s->prev=s->chain+n,s->next=s->prev+n,s->bucket=s->next+n,s->hash=(unsigned int*)(s->bucket+nb);
+	s->buckets=nb,s->head=s->tail=-1;for(int z=0;z<nb;z++)s->bucket[z]=-1;return s;
+}
+void memo_grow(lv*m){
+	memo_state*o=(memo_state*)m->f;int n=MIN(m->s*2,m->n);memo_state*s=memo_alloc(n);
+	s->hits=o->hits,s->misses=o->misses,s->count=o->count,s->head=o->head,s->tail=o->tail;
+	memcpy(s->prev,o->prev,o->count*sizeof(int)),memcpy(s->next,o->next,o->count*sizeof(int)),memcpy(s->hash,o->hash,o->count*sizeof(int));
+	for(int z=0;z<s->count;z++){int*b=&s->bucket[s->hash[z]&(s->buckets-1)];s->chain[z]=*b,*b=z;}
+	m->lv=realloc(m->lv,n*sizeof(lv*)),m->kv=realloc(m->kv,n*sizeof(lv*)),m->s=n,m->f=s;free(o);
+}
+void memo_put(lv*m,lv*a,lv*x){
+	memo_state*s=(memo_state*)m->f;unsigned int hk=lv_hash(a);int i=memo_find(m,a,hk);
+	if(i>=0){m->lv[i]=lv_shade(x),memo_unlink(s,i),memo_front(s,i);return;}
+	if(s->count<m->n){if(s->count==m->s)memo_grow(m),s=(memo_state*)m->f;i=s->count++,m->c=s->count;}
+	else{ // evict the least recently used entry, and reuse its slot
+		i=s->tail;memo_unlink(s,i);int*p=&s->bucket[s->hash[i]&(s->buckets-1)];while(*p!=i)p=&s->chain[*p];*p=s->chain[i];
+	}
+	int*b=&s->bucket[hk&(s->buckets-1)];s->hash[i]=hk,s->chain[i]=*b,*b=i,m->kv[i]=lv_shade(a),m->lv[i]=lv_shade(x),memo_front(s,i);
+}
+lv*n_memo_store(lv*self,lv*a){(void)self;lv*t=a->lv[0],*x=a->lv[1];memo_put(t->lv[0],t->lv[1],x);return x;} // ((m,args),result)
+lv*n_memo_call(lv*self,lv*a){
+	memo_state*s=(memo_state*)self->f;int i=memo_find(self,a,lv_hash(a));
+	if(i>=0){s->hits++;memo_unlink(s,i),memo_front(s,i);return self->lv[i];}
+	// a miss calls f, as eval[] does, by issuing a block which then hands the result to n_memo_store() along with the key:
+	s->misses++;lv*b=lmblk();blk_lit(b,self->a),blk_lit(b,a),blk_op(b,CALL),blk_opa(b,BUND,2),blk_lit(b,lmnat(n_memo_store,NULL)),blk_op(b,SWAP),blk_op(b,CALL);
+	issue(ev(),b);return lml2(self,a);
+}
+lv*n_memo(lv*self,lv*a){
+	(void)self;lv*f=l_first(a);
+	if(linat(f)&&f->f==(void*)n_memo_call){
+		lv*m=f->a,*r=lmd();memo_state*s=(memo_state*)m->f;
+		dset(r,lmistr("hits"),lmn(s->hits)),dset(r,lmistr("misses"),lmn(s->misses));
+		dset(r,lmistr("size"),lmn(s->count)),dset(r,lmistr("limit"),lmn(m->n));return r;
+	}
+	if(!lion(f)&&!linat(f))return NONE;int n=a->c>1?ln(a->lv[1]):0;n=n<1?1024:MIN(n,1<<24);
+	lv*m=lmv(2);m->a=f,m->n=n,m->s=MIN(n,16),m->lv=calloc(m->s,sizeof(lv*)),m->kv=calloc(m->s,sizeof(lv*)),m->f=memo_alloc(m->s);
+	return lmnat(n_memo_call,m);
+}
 void init_interns(void){for(int z=0;z<=383;z++){lv*t=&interned[z];t->t=0,t->c=1,t->nv=z-128;}}
+void lv_reset(void){ // free every value this thread has allocated, so that it may start a fresh interpreter with init_interns()
+	for(int z=0;z<gc.size;z++)lv_free(gc.heap[z]);for(int z=0;z<gc.ss;z++)idx_free(&gc.st[z].pcs);idx_free(&state.pcs);
+	free(gc.heap),free(mark.v);gc=(gc_state){0},state=(pstate){0},mark=(mark_stack){0},tel=(telemetry){0};
+	seed=0x12345,intern_count=383+1,do_panic=0,tnames=0,order_vec=NULL,blk_prow=-1,blk_rowo=-1;
+}
 void init(lv*e){state.p=lml(0),state.t=lml(0),state.e=lml(0),state.pcs=idx_new(0);ll_add(state.e,e);}
 void pushstate(lv*e){
 	if(!state.p)printf("trying to save an uninitialized state!\n");
@@ -1075,12 +1356,169 @@ void runfunc(lv*env,lv*f,lv*args){
 	if(f&&lion(f)){lv*b=lmblk();blk_lit(b,f),blk_lit(b,args),blk_op(b,CALL),blk_op(b,DROP);issue(env,b);}
 }
 void halt(void){state.e->c=0,state.t->c=0,state.p->c=0,state.pcs.c=0;}
+LIL_LOCAL void(*run_hook)(void)=NULL; // if set, called every 100 ops by run(), as for lv_collect().
 lv*run(lv*x,lv*rootenv){
-	init(rootenv),issue(rootenv,x);int c=0;while(running()){runop(),c++;if(c%100==0)lv_collect();}
+	init(rootenv),issue(rootenv,x);int c=0;while(running()){runop(),c++;if(c%100==0){lv_collect();if(run_hook)run_hook();}}
 	if(state.p->c<1)return NONE;lv*r=arg();
 	while(state.p->c)printf("STACK JUNK: "),debug_show(arg());return r;
 }
 
+// Snapshots
+
+// a snapshot flattens a graph of values into a string: a header, then a sequence of nodes which refer
+// to one another by index, the first being the root. natives and interfaces can't be flattened, so each
+// is written as the name it is bound to in a 'base' environment, and looked up by that name on load.
+#define SNAP_MAGIC   "LilS"
+#define SNAP_VERSION 1
+#define SNAP_NONE    0xFFFFFFFFu
+#define snap_h(x)    h=(h^(unsigned int)(x))*16777619u
+unsigned int snap_fingerprint(void){ // changes with the numbering of opcodes and primitives, or the host's layout
+	unsigned int h=2166136261u;int one=1;primitive*p[]={monads,dyads,triads};
+	for(int z=0;opnames[z][0];z++){for(char*c=opnames[z];*c;c++)snap_h(*c);snap_h(oplens[z]);}
+	for(int i=0;i<3;i++)for(int z=0;p[i][z].name[0];z++){for(char*c=p[i][z].name;*c;c++)snap_h(*c);snap_h(i);}
+	snap_h(sizeof(int)),snap_h(sizeof(double)),snap_h(*(char*)&one);return h;
+}
+void snap_u32(str*s,unsigned int x){char b[4]={x,x>>8,x>>16,x>>24};str_addn(s,b,4);}
+void snap_ref(str*s,lv*x){snap_u32(s,x?(unsigned int)(-x->g-1):SNAP_NONE);} // while writing, each node's mark holds -(index+1)
+void snap_str(str*s,char*x,int n){snap_u32(s,n),str_addn(s,x,n);}
+lv* snap_global(lv*base,lv*x){ // natives without closures are interchangeable if they share an implementation
+	if(base)EACH(z,base){lv*y=base->lv[z];if(y==x||(x->t==9&&y->t==9&&x->f==y->f&&!x->a&&!y->a))return base->kv[z];}return NULL;
+}
+lv* snap_base(lv*base){ // natives which the parser itself embeds in code:
+	if(!base)base=lmd();dset(base,lmistr("!uplevel"),lmnat(n_uplevel,NULL));return base;
+}
+enum blk_kinds{K_ANY,K_FN,K_BLK,K_NAMES,K_SRC,K_ACC,K_IDX}; // K_IDX+n is an index list of n elements, from BUND
+typedef struct{int d,l;unsigned char*k;}blk_state; // stack depth, loop depth, and the kind of each stacked value
+int blk_kind(lv*x){if(lion(x))return K_FN;if(x->t==7)return K_BLK;if(!lil(x))return K_ANY;EACH(z,x)if(!lis(x->lv[z]))return K_ANY;return K_NAMES;}
+int blk_check(lv*x){
+	// is x well-formed bytecode? every instruction must be known and complete, constants must exist (and name
+	// variables where a name is expected), and jumps must land on an instruction or the end. the stack is then
+	// traced along every path: it must never underflow, and must agree in depth and in the kinds of value it
+	// holds wherever paths meet. runop() trusts the shape of a few values- the function bound by BIND, the
+	// index list of IPRE/IPOST/AMEND, the names and iterator of EACH/NEXT, and the block given to COL- so each
+	// must come from the instruction the parser emits for it, and loops must unwind before a TAIL or the end.
+	static int pops[]={0,1,0,1,1,2,2,0,1,2,3,0,1,1,4,2,2,1,1,3,3,2,2,3,2,1,1},push[]={0,0,1,2,0,2,3,1,1,1,1,1,1,1,1,1,1,1,2,2,2,2,2,3,1,1,2};
+	if(!x->sv||x->n<=0||x->n>x->ns)return 0;
+	int n=x->n,nops=sizeof(oplens)/sizeof(int),np[3]={0},ok=1,c=0,d=0,l=0;long total=0;primitive*p[]={monads,dyads,triads};
+	for(int i=0;i<3;i++)while(p[i][np[i]].name[0])np[i]++;
+	char*start=calloc(n+1,1),*tgt=calloc(n+1,1),*queued=calloc(n+1,1);int*work=malloc((n+1)*sizeof(int));blk_state*at=calloc(n+1,sizeof(blk_state));unsigned char*k=malloc(n+4);
+	for(int z=0,o;ok&&z<n;z+=oplens[o]){o=blk_getb(x,z);if(o>=nops||z+oplens[o]>n){ok=0;break;}start[z]=1;}start[n]=1;
+	for(int z=0,o;ok&&z<n;z+=oplens[o]){
+		o=blk_getb(x,z);if(o!=JUMP&&o!=JUMPF&&o!=EACH&&o!=NEXT&&o!=FIDX)continue;
+		int t=blk_geti(x,z+1);if(t<0||t>n||!start[t])ok=0;else tgt[t]=1;
+	}tgt[0]=tgt[n]=1;
+	// where paths meet, a value whose kind differs between them is no longer known, and the paths after are traced again:
+	#define blk_meet(t) {blk_state*s_=&at[t];int m_=0;if(!s_->k){if((total+=d+1)>(1<<24))ok=0;else s_->d=d,s_->l=l,s_->k=malloc(d+1),memcpy(s_->k,k,d),m_=1;} \
+		else if(s_->d!=d||s_->l!=l)ok=0;else for(int q=0;q<d;q++)if(s_->k[q]!=k[q]&&s_->k[q]!=K_ANY)s_->k[q]=K_ANY,m_=1; \
+		if(ok&&m_&&(t)<n&&!queued[t])queued[t]=1,work[c++]=(t);}
+	if(ok)blk_meet(0);
+	while(ok&&c){
+		int z=work[--c];queued[z]=0,d=at[z].d,l=at[z].l,memcpy(k,at[z].k,d);
+		while(ok){
+			int o=blk_getb(x,z),i=oplens[o]>1?blk_geti(x,z+1):0,out=o==BUND?i: o==RANGE?1+!!i: pops[o];unsigned char*a=k+d-out,r[3]={K_ANY,K_ANY,K_ANY};
+			if(i<0){ok=0;break;}
+			if(o==LIT||o==GET||o==SET||o==LOC||o==AMEND)ok=i<x->c&&x->lv[i];
+			if(ok&&(o==GET||o==SET||o==LOC))ok=lis(x->lv[i]);
+			if(o==OP1||o==FMAP)ok=i<np[0];if(o==OP2)ok=i<np[1];if(o==OP3)ok=i<np[2];
+			if(!ok||d<out){ok=0;break;}
+			if(o==LIT )r[0]=blk_kind(x->lv[i]);
+			if(o==DUP )r[0]=r[1]=a[0];
+			if(o==SWAP)r[0]=a[1],r[1]=a[0];
+			if(o==OVER)r[0]=r[2]=a[0],r[1]=a[1];
+			if(o==BUND)r[0]=i<200?K_IDX+i:K_ANY;
+			if(o==BIND)ok=a[0]==K_FN;
+			if(o==AMEND)ok=a[1]>=K_IDX&&(lis(x->lv[i])||lin(x->lv[i]));
+			if(o==IPRE )ok=a[0]>=K_IDX&&i<a[0]-K_IDX,r[0]=a[0];
+			if(o==IPOST)ok=a[1]>=K_IDX&&i<a[1]-K_IDX,r[1]=a[1];
+			if(o==COL  )ok=a[1]==K_BLK;
+			if(o==TAIL )ok=l==0;
+			if(o==EACH )ok=a[0]==K_SRC&&a[1]==K_ACC&&a[2]==K_NAMES;
+			if(o==NEXT )ok=a[0]==K_SRC&&a[1]==K_ACC&&l>0;
+			if(o==RANGE)ok=i<=2;
+			if(o==ITER||o==EACH||o==NEXT||o==RANGE)r[0]=K_SRC,r[1]=K_ACC;
+			if(!ok)break;d-=out;
+			if(o==EACH){k[d++]=K_ANY;blk_meet(i);d--,l++;} // leaving the loop with its result, or binding the next element
+			if(o==NEXT)l--;
+			memcpy(k+d,r,push[o]),d+=push[o];
+			if(o==JUMP||o==JUMPF||o==NEXT||o==FIDX)blk_meet(i);
+			if(o==JUMP||o==NEXT)break;z+=oplens[o];if(tgt[z]){blk_meet(z);break;}
+		}
+	}
+	if(ok&&(!at[n].k||at[n].d!=1||at[n].l))ok=0;
+	for(int z=0;z<=n;z++)free(at[z].k);free(start),free(tgt),free(queued),free(work),free(at),free(k);return ok;
+}
+char* snap_write(str*s,lv*root,lv*base){
+	static LIL_LOCAL char err[128];err[0]='\0';int c=0,size=64;lv**v=malloc(size*sizeof(lv*));
+	#define snap_visit(x) {lv*n_=(x);if(n_&&n_->g>=0){if(c>=size)v=realloc(v,(size*=2)*sizeof(lv*));v[c]=n_,n_->g=-(++c);}}
+	snap_visit(root);for(int i=0;i<c;i++){ // breadth-first, using the node list itself as the queue
+		lv*x=v[i];if(x->t==6||x->t==9){
+			if(!snap_global(base,x)&&!err[0])snprintf(err,sizeof(err),"unable to save a value of type %s",l_typeof(x)->sv);continue;
+		}
+		if(x->t==2||x->t==3||x->t==4||x->t==5||x->t==7||x->t==8)EACH(z,x)snap_visit(x->lv[z]);
+		if(x->t==3||x->t==4||x->t==8)EACH(z,x)snap_visit(x->kv[z]);
+		if(x->t==5||x->t==8)snap_visit(x->env);if(x->t==5||x->t==7)snap_visit(x->b);if(x->t==7)snap_visit(x->a);
+	}
+	if(!err[0]){
+		str_addn(s,SNAP_MAGIC,4),snap_u32(s,SNAP_VERSION),snap_u32(s,snap_fingerprint()),snap_u32(s,c);
+		for(int i=0;i<c;i++){
+			lv*x=v[i];if(x->t==6||x->t==9){lv*n=snap_global(base,x);str_addraw(s,10),snap_str(s,n->sv,n->c);continue;}str_addraw(s,x->t);
+			if(x->t==0){str_addn(s,(char*)&x->nv,sizeof(double));}
+			if(x->t==1){snap_str(s,x->sv,x->c);}
+			if(x->t==5){snap_str(s,x->sv,strlen(x->sv));}
+			if(x->t==7){snap_str(s,x->sv,x->n);}
+			if(x->t==2||x->t==3||x->t==4||x->t==5||x->t==7||x->t==8){snap_u32(s,x->c);EACH(z,x)snap_ref(s,x->lv[z]);}
+			if(x->t==3||x->t==4||x->t==8){snap_u32(s,x->n);EACH(z,x)snap_ref(s,x->kv[z]);}
+			if(x->t==5||x->t==8)snap_ref(s,x->env);if(x->t==5||x->t==7)snap_ref(s,x->b);if(x->t==7)snap_ref(s,x->a);
+		}
+	} // give back the borrowed marks. if marking is under way, these nodes may not have been scanned yet: mark them afresh.
+	for(int i=0;i<c;i++)v[i]->g=gc.g-gc.marking,lv_shade(v[i]);free(v);return err[0]?err:NULL;
+}
+typedef struct{unsigned char*b;unsigned int i,n;int err;}snap_in;
+unsigned int snap_get(snap_in*s){
+	if(s->n-s->i<4){s->err=1;return 0;}unsigned char*p=s->b+s->i;s->i+=4;
+	return p[0]|p[1]<<8|p[2]<<16|(unsigned int)p[3]<<24;
+}
+char* snap_bytes(snap_in*s,unsigned int n){if(s->n-s->i<n){s->err=1;return NULL;}char*r=(char*)s->b+s->i;s->i+=n;return r;}
+lv** snap_slots(snap_in*s,lv**r,int n){for(int z=0;z<n;z++)r[z]=(lv*)(size_t)(1+snap_get(s));return r;} // relocated later
+lv* snap_read(char*text,int size,lv*base){
+	// pass one builds a shell for each node, holding (index+1) in place of every reference.
+	// pass two relocates those into pointers, and checks that each refers to the right kind of value.
+	snap_in s={(unsigned char*)text,0,size,0};char*m=snap_bytes(&s,4);
+	if(!m||memcmp(m,SNAP_MAGIC,4)||snap_get(&s)!=SNAP_VERSION||snap_get(&s)!=snap_fingerprint())return NULL;
+	unsigned int c=snap_get(&s);if(s.err||c<1||c>s.n-s.i)return NULL;lv**v=calloc(c,sizeof(lv*));
+	for(unsigned int i=0;i<c&&!s.err;i++){
+		char*tp=snap_bytes(&s,1);if(!tp)break;int t=*tp;lv*x=NULL;
+		if(t==0){char*d=snap_bytes(&s,sizeof(double));double n=0;if(d)memcpy(&n,d,sizeof(double));x=lmn(n);}
+		else if(t==1||t==5||t==7||t==10){
+			unsigned int n=snap_get(&s);char*d=snap_bytes(&s,n);if(!d)break;
+			if(t==10){lv*k=lmv(1);k->c=n,k->sv=calloc(n+1,1),memcpy(k->sv,d,n);x=dget(base,k);if(!x||(x->t!=6&&x->t!=9))s.err=1;}
+			else if(t==1){x=lms(n);memcpy(x->sv,d,n);}
+			else if(t==5){x=lmv(5);x->sv=calloc(n+1,1),memcpy(x->sv,d,n);}
+			else{x=lmv(7);x->sv=malloc(n+1),x->ns=n+1,x->n=n;memcpy(x->sv,d,n);}
+		}
+		else if(t==2||t==3||t==4||t==8){x=lmv(t);}
+		else{s.err=1;break;}
+		if(t==2||t==3||t==4||t==5||t==7||t==8){
+			unsigned int n=snap_get(&s);if(n>(s.n-s.i)/4){s.err=1;break;}
+			x->s=MAX(n,8),x->c=n,x->lv=snap_slots(&s,calloc(x->s,sizeof(lv*)),n);
+			if(t!=2&&t!=5&&t!=7){x->n=snap_get(&s);x->kv=snap_slots(&s,calloc(x->s,sizeof(lv*)),n);}
+			if(t==5||t==8)x->env=snap_slots(&s,&x->env,1)[0];if(t==5||t==7)x->b=snap_slots(&s,&x->b,1)[0];if(t==7)x->a=snap_slots(&s,&x->a,1)[0];
+		}v[i]=x;
+	}
+	#define snap_fix(p,ok) {size_t r_=(size_t)(p);p=r_&&r_<=c?v[r_-1]:NULL;if((r_&&!p)||!(ok))s.err=1;}
+	#define snap_is(x,n)   ((x)&&(x)->t==(n))
+	for(unsigned int i=0;i<c;i++){
+		lv*x=v[i];if(!x){s.err=1;continue;}if(x->t==0||x->t==1||x->t==6||x->t==9)continue;
+		EACH(z,x){snap_fix(x->lv[z],x->lv[z]);if(x->kv)snap_fix(x->kv[z],x->kv[z]&&(x->t==3||lis(x->kv[z])));}
+		if(x->t==5){EACH(z,x)if(!lis(x->lv[z]))s.err=1;snap_fix(x->env,!x->env||snap_is(x->env,8));snap_fix(x->b,snap_is(x->b,7));}
+		if(x->t==8){snap_fix(x->env,!x->env||snap_is(x->env,8));}
+		if(x->t==7){snap_fix(x->a,!x->a||lis(x->a));snap_fix(x->b,!x->b||lis(x->b));}
+		if(x->t==4){EACH(z,x)if(!lil(x->lv[z])||x->lv[z]->c!=x->n)s.err=1;}
+	}
+	for(unsigned int i=0;i<c&&!s.err;i++)if(v[i]->t==7&&!blk_check(v[i]))s.err=1; // once every reference is in place
+	lv*r=s.err||s.i!=s.n?NULL:v[0];free(v);return r;
+}
+
 // Standard Library
 
 #define ivalue(x,k)    dget(x->b,lmistr(k))
@@ -1100,7 +1538,8 @@ void show(str*s,lv*x,int toplevel){
 		}str_addc(s,'}');
 	}
 	else if(lis(x)){
-		str_addc(s,'"');EACH(z,x){
+		str_addc(s,'"');for(int z=0;z<x->c;z++){
+			int r=z;while(r<x->c&&plain(x->sv[r],"\"\\"))r++;if(r>z){str_addn(s,x->sv+z,r-z);z=r;if(z>=x->c)break;}
 			char c=x->sv[z];if(c=='\n'?(c='n',1):!!strchr("\"\\",c))str_addc(s,'\\');str_addc(s,c);
 		}str_addc(s,'"');
 	}
@@ -1141,47 +1580,90 @@ lv*n_printf(lv*a,int newline,FILE*out){
 	else{a=l_format(ls(l_first(a)),l_drop(ONE,a));fprintf(out,"%s",a->sv);}
 	if(newline)fprintf(out,"\n");return a;
 }
+typedef struct{str b;FILE*f;int eof,cn;char carry[8];}csv_src; // a string, or a file which is read and cleaned in chunks
+#define CSV_CHUNK 65536
+int utf8w(unsigned char c){return (c&0xF0)==0xF0?4:(c&0xE0)==0xE0?3:(c&0xC0)==0xC0?2:1;} // bytes str_add() consumes for c
+int csv_fill(csv_src*s){
+	char t[CSV_CHUNK+16];int c0=s->b.c;while(!s->eof){
+		memcpy(t,s->carry,s->cn);int r=fread(t+s->cn,1,CSV_CHUNK,s->f),n=s->cn+r,z=0;char*nul=memchr(t,0,n);
+		if(nul||r<1)s->eof=1,n=nul?nul-t:n;memset(t+n,0,8); // like read[], stop at the first NUL
+		if(!s->eof)while(z<n){unsigned char c=t[z];int w=utf8w(c);if(z+w>n)break;z+=w;}else z=n;
+		s->cn=n-z;memcpy(s->carry,t+z,s->cn); // carry partial UTF-8 sequences
+		for(int p=0,q;p<z;p=q){
+			q=p+str_plain(t+p,z-p);str_addn(&s->b,t+p,q-p);if(q>=z)break;
+			int w=utf8w(t[q]);str_add(&s->b,t+q,w),q+=w;
+		}if(s->b.c>c0)return 1;
+	}return 0;
+}
+int csv_has(csv_src*s,int i){while(i>=s->b.c&&csv_fill(s)){}return i<s->b.c;}
+int csv_drop(csv_src*s,int i){ // discard consumed rows from a file buffer
+	if(!s->f||i<CSV_CHUNK)return 0;memmove(s->b.sv,s->b.sv+i,s->b.c-i);s->b.c-=i;return i;
+}
+int csv_num(char*t,int n){ // is t a decimal number like 12, -3.5 or 1e6, with optional trailing spaces?
+	int z=t[0]=='-',d=0;while(z<n&&isdigit(t[z]))z++,d++;
+	if(z<n&&t[z]=='.'){z++;while(z<n&&isdigit(t[z]))z++,d++;}if(!d)return 0;
+	if(z<n&&(t[z]=='e'||t[z]=='E')){z++;if(z<n&&(t[z]=='+'||t[z]=='-'))z++;int e=z;while(z<n&&isdigit(t[z]))z++;if(z==e)return 0;}
+	while(z<n&&t[z]==' ')z++;return z==n;
+}
+void csv_infer(lv*c){int k=0;EACH(z,c){lv*v=c->lv[z];if(v->c&&!csv_num(v->sv,v->c))return;k|=v->c>0;}if(k)EACH(z,c)c->lv[z]=lmn(pjson_num(c->lv[z]->sv,c->lv[z]->c));}
 #define fchar(x) (x=='I'?'i': x=='B'?'b': x=='L'?'s': x)
-lv*n_readcsv(lv*self,lv*a){
-	#define cm(x) t->sv[i]==x?(i++,1):0
+lv* csv_f(str v){ // as l_parse["%f" v], without parsing the pattern again for every cell of an f column
+	char*y=v.sv;int n=v.c,h=0;while(h<n&&isspace(y[h]))h++;int s=h<n&&y[h]=='-'?(h++,-1):1,ds=h;
+	while(h<n&&isdigit(y[h]))h++;if(h<n&&y[h]=='.')h++;while(h<n&&isdigit(y[h]))h++;double r=s*pjson_num(y+ds,h-ds);return free(v.sv),lmn(r);
+}
+lv*readcsv(csv_src*in,lv*a){
+	#define ch(x) ((x)<in->b.c||csv_has(in,x))
+	#define ca(x) (ch(x)?in->b.sv[x]:0)
+	#define cm(x) ca(i)==x?(i++,1):0
 	#define css   while(cm(' ')){}
-	(void)self;lv*t=a->c>0?ls(a->lv[0]):lms(0);lv*r=lmt(),*s=(a->c>=2&&lis(a->lv[1]))?a->lv[1]:NULL;
-	char delim=a->c>=3?ls(a->lv[2])->sv[0]:',';
-	int i=0,n=0,slots=0,slot=0;;char b[32];while(i<t->c&&t->sv[i]!='\n'){
-		css;str name=str_new();while(i<t->c&&t->sv[i]!='\n'&&t->sv[i]!=delim)str_addc(&name,t->sv[i++]);
+	lv*r=lmt(),*s=(a->c>=1&&lis(a->lv[0]))?a->lv[0]:NULL;
+	char delim=a->c>=2?ls(a->lv[1])->sv[0]:',';int limit=a->c>=3?MAX(-1,ln(a->lv[2])):-1,rows=0;
+	int i=0,n=0,slots=0,slot=0;;char b[32];while(ch(i)&&ca(i)!='\n'){
+		css;str name=str_new();while(ch(i)&&ca(i)!='\n'&&ca(i)!=delim)str_addc(&name,in->b.sv[i++]);
 		if(!s||(n<s->c&&s->sv[n]!='_'))dset(r,lmstr(name),lml(0));else free(name.sv);n++;
-		if(t->sv[i++]=='\n')break;css;cm(delim);
+		if(ca(i)=='\n'){i++;break;}i++;css;cm(delim);
 	}while(s&&n<s->c)if(s->sv[n++]!='_')snprintf(b,32,"c%d",n-1),dset(r,lmcstr(b),lml(0));
 	if(!s)s=l_take(lmn(r->c),lmistr("s"));EACH(z,s)if(s->sv[z]!='_')slots++;slots=MIN(slots,r->c);
 	char f[]={'%',0,0};MAP(fmts,s)(f[1]=fchar(s->sv[z]),lmcstr(f));
-	n=0;while(i<=t->c){
-		css;str val=str_new();
-		if(cm('"'))while(i<t->c)if(cm('"')){if(cm('"'))str_addc(&val,'"');else break;}else str_addc(&val,t->sv[i++]);
-		else{while(i<t->c&&!strchr("\n\"",t->sv[i])&&t->sv[i]!=delim)str_addc(&val,t->sv[i++]);}
-		if(n<s->c&&s->sv[n]!='_'){ll_add(r->lv[slot++],s->sv[n]=='s'?lmstr(val): l_parse(fmts->lv[n],lmstr(val)));}
+	n=0;while(rows!=limit&&ch(i-1)){
+		css;str val=str_new();int e=i;
+		if(cm('"'))while(ch(i))if(cm('"')){if(cm('"'))str_addc(&val,'"');else break;}
+			else{e=i;while(ch(e)&&in->b.sv[e]!='"')e++;str_addr(&val,in->b.sv+i,e-i),i=e;}
+		else{while(ch(e)&&!strchr("\n\"",in->b.sv[e])&&in->b.sv[e]!=delim)e++;str_addr(&val,in->b.sv+i,e-i),i=e;}
+		if(n<s->c&&s->sv[n]!='_'&&slot<slots){ll_add(r->lv[slot++],strchr("s?",s->sv[n])?lmstr(val): s->sv[n]=='f'?csv_f(val): l_parse(fmts->lv[n],lmstr(val)));}
 		else{free(val.sv);}n++;
-		if(i>=t->c||t->sv[i]=='\n'){
-			while(n<s->c){char u=s->sv[n++];if(u!='_'&&slot<slots)ll_add(r->lv[slot++],strchr("sluvroq",u)?lms(0):NONE);}
-			if(t->sv[i]=='\n'&&i==t->c-1)break;i++,n=0,slot=0;
+		if(!ch(i)||ca(i)=='\n'){
+			while(n<s->c){char u=s->sv[n++];if(u!='_'&&slot<slots)ll_add(r->lv[slot++],strchr("sluvroq?",u)?lms(0):NONE);}
+			if(ca(i)=='\n'&&!ch(i+1))break;i++,n=0,slot=0,rows++;i-=csv_drop(in,i);
 		}else{css;cm(delim);}
-	}return torect(r);
+	}slot=0;EACH(z,s)if(s->sv[z]!='_'&&slot<r->c){if(s->sv[z]=='?')csv_infer(r->lv[slot]);slot++;}return torect(r);
 }
-lv*n_writecsv(lv*self,lv*a){
-	(void)self;str r=str_new();lv*t=lt(l_first(a)),*s=a->c>1?ls(a->lv[1]):l_take(lmn(t->c),lmistr("s"));
-	char delim=a->c>=3?ls(a->lv[2])->sv[0]:',';
+lv*n_readcsv(lv*self,lv*a){
+	(void)self;lv*t=a->c>0?ls(a->lv[0]):lms(0);csv_src in={{t->c,t->c+1,t->sv},NULL,1,0,{0}};
+	return readcsv(&in,l_drop(ONE,a));
+}
+typedef struct{str b;FILE*f;}csv_sink; // a string builder, optionally drained to a file in chunks
+void csv_cell(str*r,char*v,int n,char delim){
+	int e=0;for(int z=0;z<n&&!e;z++)e=v[z]=='\n'||v[z]=='"'||v[z]==delim;if(!e){str_addr(r,v,n);return;}
+	str_addc(r,'"');for(int z=0;z<n;){int q=z;while(q<n&&v[q]!='"')q++;str_addr(r,v+z,q-z);if(q<n)str_add(r,"\"\"",2),q++;z=q;}str_addc(r,'"');
+}
+void writecsv(csv_sink*o,lv*a){
+	str*r=&o->b;lv*t=lt(l_first(a)),*s=a->c>1?ls(a->lv[1]):l_take(lmn(t->c),lmistr("s"));
+	char delim=a->c>=3?ls(a->lv[2])->sv[0]:',';int nd=!strchr("-.0123456789",delim); // can numbers skip the quoting check?
 	int n=0;EACH(c,s)if(s->sv[c]!='_'){
-		if(n++)str_addc(&r,delim);char b[32];
-		if(c>=t->c)str_add(&r,b,snprintf(b,32,"c%d",c+1));else str_addl(&r,t->kv[c]);
-	}
+		if(n++)str_addc(r,delim);char b[32];
+		if(c>=t->c)str_add(r,b,snprintf(b,32,"c%d",c+1));else str_addl(r,t->kv[c]);
+	}str rc=str_new();
 	for(int z=0;z<t->n;z++){
-		str_addc(&r,'\n');int n=0;EACH(c,s)if(s->sv[c]!='_'){
-			if(n++)str_addc(&r,delim);
-			str rc=str_new();format_type_simple(&rc,c>=t->c?lms(0):t->lv[c]->lv[z],fchar(s->sv[c]));lv*o=lmstr(rc);
-			int e=0;EACH(z,o)e|=(!!strchr("\n\"",o->sv[z]))||o->sv[z]==delim;
-			if(e)str_addc(&r,'"');EACH(z,o){if(o->sv[z]=='"')str_addc(&r,'"');str_addc(&r,o->sv[z]);}if(e)str_addc(&r,'"');
-		}
-	}return lmstr(r);
-}
+		str_addc(r,'\n');int n=0;EACH(c,s)if(s->sv[c]!='_'){
+			if(n++)str_addc(r,delim);lv*v=c>=t->c?lms(0):t->lv[c]->lv[z];char f=fchar(s->sv[c]);
+			if(lin(v)&&nd&&(f=='s'||f=='f')){wnum(r,v->nv);continue;}
+			if(lis(v)&&f=='s'){csv_cell(r,v->sv,v->c,delim);continue;}
+			rc.c=0;format_type_simple(&rc,v,f);csv_cell(r,rc.sv,rc.c,delim);
+		}if(o->f&&r->c>=CSV_CHUNK)fwrite(r->sv,1,r->c,o->f),r->c=0;
+	}free(rc.sv);if(o->f)fwrite(r->sv,1,r->c,o->f),r->c=0;
+}
+lv*n_writecsv(lv*self,lv*a){(void)self;csv_sink o={str_new(),NULL};writecsv(&o,a);return lmstr(o.b);}
 void writexmlstr(str*s,lv*x){
 	#define xc(a,b) if(c==a)str_addz(s,"&" #b ";"),c=0;
 	EACH(z,x){char c=x->sv[z];xc('&',amp)xc('\'',apos)xc('"',quot)xc('>',gt)xc('<',lt)if(c)str_addc(s,c);}
@@ -1205,43 +1687,55 @@ void writexmlrec(str*s,lv*x,int tab,int fmt){
 	indent(tab);str_addz(s,"</"),str_addz(s,t->sv);str_addz(s,fmt?">\n":">");
 }
 lv*n_writexml(lv*self,lv*a){(void)self;str r=str_new();writexmlrec(&r,l_first(a),0,a->c>1?lb(a->lv[1]):0);return lmstr(r);}
-lv*readxmltext(char*t,int*i,char stop){
-	str r=str_new();while(t[*i]&&!(stop==' '&&strchr(">/ \n",t[*i]))){
+void readxmltexts(str*r,char*t,int*i,char stop){
+	while(t[*i]&&!(stop==' '&&strchr(">/ \n",t[*i]))){
 		#define xs      while(isspace(t[*i]))++*i
 		#define xi(a,b) !strncmp(&t[*i],a,strlen(a))? ((*i)+=strlen(a),b):
 		#define xr(a,b) xi("&" #a ";",b)
-		int w=0;xs,w=1;if(w)str_addc(&r,' ');if(stop==t[*i]||!t[*i])break;
-		str_addc(&r,xr(amp,'&')xr(apos,'\'')xr(quot,'"')xr(gt,'>')xr(lt,'<')xr(nbsp,' ')((*i)++,t[*i-1]));
-	}if(strchr("'\"",stop)&&t[*i])++*i;return lmstr(r);
-}
-lv*readxmlname(char*t,int*i){
-	str r=str_new();xs;while(!strchr(">/= \n\0",t[*i]))str_addc(&r,tolower(t[(*i)++]));xs;return lmstr(r);
-}
-lv*readxmlrec(char*t,int*i,char*currtag){
+		int w=0;xs,w=1;if(w)str_addc(r,' ');if(stop==t[*i]||!t[*i])break;
+		str_addc(r,xr(amp,'&')xr(apos,'\'')xr(quot,'"')xr(gt,'>')xr(lt,'<')xr(nbsp,' ')((*i)++,t[*i-1]));
+	}if(strchr("'\"",stop)&&t[*i])++*i;
+}
+void readxmlnames(str*r,char*t,int*i){xs;while(!strchr(">/= \n\0",t[*i]))str_addc(r,tolower(t[(*i)++]));xs;}
+lv*readxmltext(char*t,int*i,char stop){str r=str_new();readxmltexts(&r,t,i,stop);return lmstr(r);}
+lv*readxmlname(char*t,int*i){str r=str_new();readxmlnames(&r,t,i);return lmstr(r);}
+typedef struct{lv*r;char*name;int m;}xml_frame; // an open tag: its children (or NULL if discarded), and how much of the path filter it matched
+int readxmlseg(lv*seg,int m,str*n){lv*s=seg->lv[m];return (s->c==1&&s->sv[0]=='*')||(s->c==n->c&&!memcmp(s->sv,n->sv,n->c));}
+lv*readxml(char*t,lv*path){
+	// iterative, so deep documents can't exhaust the C stack. Given a path filter like "rss/channel/item",
+	// only the elements at that path (and their contents) are built, and returned as a flat list.
 	#define xcl   while(t[*i]&&t[*i]!='>')++*i;++*i;
 	#define xm(x) t[*i]==x?(++*i,1):0
-	lv*r=lml(0);while(t[*i]){
-		int w=0;xs,w=1;
+	int ii=0,*i=&ii,sp=1,sz=16;lv*root=lml(0),*seg=NULL;str n=str_new();xml_frame*f=malloc(sz*sizeof(xml_frame));
+	if(path&&path->c){str p=str_new();EACH(z,path)str_addc(&p,tolower(path->sv[z]));seg=l_split(lmistr("/"),lmstr(p));}
+	f[0]=(xml_frame){seg?NULL:root,strdup(""),0};while(t[*i]){
+		lv*r=f[sp-1].r;int w=0;xs,w=1;
 		if(!strncmp(&t[*i],"<![CDATA[",9)){
-			(*i)+=9;str c=str_new();
-			while(t[*i]&&strncmp(&t[*i],"]]>",3))str_addc(&c,t[(*i)++]);
-			(*i)+=3;ll_add(r,lmstr(c));continue;
+			(*i)+=9;int e=*i;while(t[e]&&strncmp(&t[e],"]]>",3))e++;
+			if(r){str c=str_new();str_add(&c,t+*i,e-*i);ll_add(r,lmstr(c));}*i=e+3;continue;
 		}
-		if(t[*i]!='<'){if(w)(*i)--;ll_add(r,readxmltext(t,i,'<'));continue;}
+		if(t[*i]!='<'){if(w)(*i)--;if(r){ll_add(r,readxmltext(t,i,'<'));}else{n.c=0,readxmltexts(&n,t,i,'<');}continue;}
 		++*i;xs;
 		if(xm('!')||xm('?')){xcl;continue;}// skip pragmas/comments/prolog
-		if(xm('/')){lv*n=readxmlname(t,i);xm('>');if(!strcmp(currtag,n->sv))break;continue;}
-		lv*tag=lmd(),*attr=lmd(),*n=readxmlname(t,i);ll_add(r,tag);
-		dset(tag,lmistr("tag"),n),dset(tag,lmistr("attr"),attr),dset(tag,lmistr("children"),lml(0));
-		while(!strchr("/>\0",t[*i])){
-			lv*n=readxmlname(t,i);
-			if(xm('=')){xs;dset(attr,n,readxmltext(t,i,(xm('\''))?'\'':(xm('"'))?'"':' '));}
-			else{dset(attr,n,ONE);}
+		n.c=0;int close=xm('/');readxmlnames(&n,t,i);if(close){
+			xm('>');char*c=f[sp-1].name;if((int)strlen(c)!=n.c||memcmp(c,n.sv,n.c))continue;
+			if(sp==1)break;free(c),sp--;continue;
 		}
-		if(xm('/')){xcl;}else{if(t[*i])++*i;dset(tag,lmistr("children"),readxmlrec(t,i,n->sv));}
-	}return r;
+		int m=r||!seg||f[sp-1].m<0?f[sp-1].m: readxmlseg(seg,f[sp-1].m,&n)?f[sp-1].m+1:-1;
+		lv*tag=NULL,*attr=NULL,*kids=NULL;if(r||(seg&&m==seg->c)){
+			tag=lmd(),attr=lmd(),kids=lml(0);ll_add(r?r:root,tag);str_term(&n);
+			dset(tag,lmistr("tag"),lmcstr(n.sv)),dset(tag,lmistr("attr"),attr),dset(tag,lmistr("children"),kids);
+		}
+		str_term(&n);char*name=strdup(n.sv);while(!strchr("/>\0",t[*i])){
+			n.c=0;readxmlnames(&n,t,i);lv*v=ONE;
+			if(xm('=')){xs;char q=(xm('\''))?'\'':(xm('"'))?'"':' ';if(attr){v=readxmltext(t,i,q);}else{str s=str_new();readxmltexts(&s,t,i,q);free(s.sv);}}
+			if(attr)str_term(&n),dset(attr,lmcstr(n.sv),v);
+		}
+		if(xm('/')){xcl;free(name);continue;}if(t[*i])++*i;
+		if(sp>=sz)f=realloc(f,(sz*=2)*sizeof(xml_frame));f[sp++]=(xml_frame){kids,name,m};
+	}while(sp)free(f[--sp].name);free(f),free(n.sv);return root;
 }
-lv*n_readxml(lv*self,lv*a){(void)self;int i=0;return readxmlrec(ls(l_first(a))->sv,&i,"");}
+lv*n_readxml(lv*self,lv*a){(void)self;return readxml(ls(l_first(a))->sv,a->c>1?ls(a->lv[1]):NULL);}
 
 #ifdef _WIN32
 #include <windows.h>
@@ -1269,7 +1763,7 @@ lv* n_random(lv*self,lv*z){
 	for(int i=x->c-1;i>0;i--){int j=randint(i+1);int t=pv.iv[j];pv.iv[j]=pv.iv[i],pv.iv[i]=t;}
 	GEN(r,abs(y))x->lv[pv.iv[z%x->c]];idx_free(&pv);return r;
 }
-int frame_count=0;
+LIL_LOCAL int frame_count=0;
 #if defined(__APPLE__) && defined(__MACH__)
 #define PLATFORM "mac"
 #elif defined(__unix__) || defined(__unix)
@@ -1279,10 +1773,67 @@ int frame_count=0;
 #else
 #define PLATFORM "other"
 #endif
+char*lv_types[]={"number","string","list","dict","table","function","interface","block","env","native"};
+lv* workspace(void){
+	lv*r=lmd(),*o=lmd(),*b=lmd();
+	dset(r,lmistr("allocs"  ),lmn(gc.allocs));
+	dset(r,lmistr("frees"   ),lmn(gc.frees ));
+	dset(r,lmistr("gcs"     ),lmn(gc.g     ));
+	dset(r,lmistr("live"    ),lmn(gc.live  ));
+	dset(r,lmistr("heap"    ),lmn(gc.size  ));
+	dset(r,lmistr("depth"   ),lmn(gc.depth ));
+	dset(r,lmistr("ops"     ),lmn(gc.ops   ));
+	dset(r,lmistr("gctime"  ),lmn(tel.pause));
+	dset(r,lmistr("gcmax"   ),lmn(tel.maxpause));
+	dset(r,lmistr("finds"   ),lmn(tel.finds));
+	dset(r,lmistr("probes"  ),lmn(tel.probes));
+	dset(r,lmistr("lookups" ),lmn(tel.lookups));
+	dset(r,lmistr("hops"    ),lmn(tel.hops));
+	dset(r,lmistr("maxhops" ),lmn(tel.maxhops));
+	for(int z=0;opnames[z][0];z++)dset(o,lmistr(opnames[z]),lmn(tel.ops[z]));dset(r,lmistr("opcodes"),o);
+	for(int z=0;z<10;z++)dset(b,lmistr(lv_types[z]),lmn(tel.bytes[z]));dset(r,lmistr("bytes"),b);
+	return r;
+}
+typedef struct{long n[10],b[10];}census;
+LIL_LOCAL lv*(*census_roots)(void)=NULL; // host hook: a dict of named values (cards, modules...) to attribute retained sizes to
+long lv_bytes(lv*x){ // approximate footprint of a single value, excluding anything it refers to
+	long r=sizeof(lv);if(x->lv)r+=x->s*sizeof(lv*);if(x->kv)r+=x->s*sizeof(lv*);
+	if(x->sv&&!(x->t==1&&x->b))r+=x->t==1?x->c+1: x->t==7?x->ns: (long)strlen(x->sv)+1;if(x->t==2&&x->f)r+=memo_bytes(x->s);return r;
+}
+LIL_LOCAL census*census_to=NULL;
+void census_visit(lv*x){census_to->n[x->t]++,census_to->b[x->t]+=lv_bytes(x);}
+void census_walk(lv*x,census*c){census_to=c,mark.visit=census_visit;lv_walk(x);mark.visit=NULL;}
+void census_row(lv*t,char*kind,lv*name,census*c,census*total){
+	long n=0,b=0;for(int z=0;z<10;z++){n+=c->n[z],b+=c->b[z];if(total)total->n[z]+=c->n[z],total->b[z]+=c->b[z];}
+	ll_add(dget(t,lmistr("kind")),lmistr(kind)),ll_add(dget(t,lmistr("name")),name);
+	ll_add(dget(t,lmistr("values")),lmn(n)),ll_add(dget(t,lmistr("bytes")),lmn(b)),t->n++;
+}
+lv* n_census(lv*self,lv*a){
+	// each root is credited with everything reachable from it that no earlier root has already claimed;
+	// whatever is left over is only reachable from the interpreter stacks, and is credited to "(other)".
+	// roots refer to one another (cards to their deck, closures to the environments they were bound in),
+	// so every root and enclosing scope is fenced off (marked in advance) until it is reached in turn.
+	// this borrows the collector's marks, so any collection under way is settled first.
+	lv_settle();lv*e=state.e&&state.e->c?ev():NULL,*scopes=lml(0);while(e){ll_add(scopes,e);if(!e->env)break;e=e->env;}
+	lv*roots=census_roots?census_roots():NULL;if(!roots)roots=e?e:lmd();
+	lv*r=lmt();dset(r,lmistr("kind"),lml(0)),dset(r,lmistr("name"),lml(0)),dset(r,lmistr("values"),lml(0)),dset(r,lmistr("bytes"),lml(0));
+	census total={{0},{0}};gc.g+=2;EACH(z,scopes)scopes->lv[z]->g=gc.g;EACH(z,roots)if(roots->lv[z])roots->lv[z]->g=gc.g;
+	EACH(z,roots){
+		census c={{0},{0}};lv*x=roots->lv[z];int seen=0;for(int i=0;i<z;i++)seen|=roots->lv[i]==x;
+		if(x&&!seen)x->g=gc.g-1;census_walk(x,&c);census_row(r,"root",roots->kv[z],&c,&total);
+	}
+	census c={{0},{0}};EACH(z,scopes)scopes->lv[z]->g=gc.g-1;(void)self,(void)a;
+	for(int z=0;z<gc.ss;z++){census_walk(gc.st[z].e,&c),census_walk(gc.st[z].p,&c),census_walk(gc.st[z].t,&c);}
+	census_walk(state.e,&c),census_walk(state.p,&c),census_walk(state.t,&c);census_row(r,"root",lmistr("(other)"),&c,&total);
+	for(int z=0;z<10;z++){census t={{0},{0}};t.n[z]=total.n[z],t.b[z]=total.b[z];census_row(r,"type",lmistr(lv_types[z]),&t,NULL);}
+	return r;
+}
+void workspace_reset(void){gc.allocs=gc.frees=gc.ops=gc.depth=0;tel=(telemetry){0};}
 #define ikey(name) if(i&&lis(i)&&!strcmp(i->sv,name))
 lv*interface_sys(lv*self,lv*i,lv*x){
 	if(x&&lis(i)){
 		ikey("seed"      ){seed=0xFFFFFFFF&(long long int)ln(x);return x;}
+		ikey("workspace" ){workspace_reset();return x;}
 	}else if(lis(i)){
 		ikey("version"   )return lmistr(VERSION);
 		ikey("platform"  )return lmistr(PLATFORM);
@@ -1290,15 +1841,6 @@ lv*interface_sys(lv*self,lv*i,lv*x){
 		ikey("frame"     )return lmn(frame_count);
 		ikey("now"       ){time_t now;time(&now);return lmn(now);}
 		ikey("ms"        )return time_ms();
-		ikey("workspace"){
-			lv*r=lmd();
-			dset(r,lmistr("allocs"  ),lmn(gc.allocs));
-			dset(r,lmistr("frees"   ),lmn(gc.frees ));
-			dset(r,lmistr("gcs"     ),lmn(gc.g     ));
-			dset(r,lmistr("live"    ),lmn(gc.live  ));
-			dset(r,lmistr("heap"    ),lmn(gc.size  ));
-			dset(r,lmistr("depth"   ),lmn(gc.depth ));
-			return r;
-		}
+		ikey("workspace" )return workspace();
 	}return x?x:NONE;(void)self;
 }
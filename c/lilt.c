@@ -4,12 +4,19 @@
 #ifndef __COSMOPOLITAN__
 #include <sys/wait.h>
 #include <unistd.h>
+#include <pthread.h>
 #endif
+#include <setjmp.h>
 
 #include "lib/bestline.h"
 #include "lib/bestline.c"
 
-lv*n_exit(lv*self,lv*a){(void)self;exit(ln(l_first(a)));}
+// each thread runs an interpreter of its own: a job's output, and exit[], are routed per-thread (see lilt_job()).
+LIL_LOCAL FILE*out_stream=NULL,*err_stream=NULL;LIL_LOCAL jmp_buf*exit_trap=NULL;LIL_LOCAL int exit_code=0;
+#define OUT (out_stream?out_stream:stdout)
+#define ERR (err_stream?err_stream:stderr)
+
+lv*n_exit(lv*self,lv*a){(void)self;exit_code=ln(l_first(a));if(exit_trap)longjmp(*exit_trap,1);exit(exit_code);}
 lv*n_input(lv*self,lv*a){
 	(void)self;char*line=bestline((a->c<2?ls(l_first(a)): l_format(ls(l_first(a)),l_drop(ONE,a)))->sv);
 	if(!line)return NONE;lv*r=lmutf8(line);free(line);return r;
@@ -29,6 +36,7 @@ lv*n_readwav(lv*self,lv*a){
 lv*n_readfile(lv*self,lv*a){
 	lv*name=ls(l_first(a));
 	if(a->c>1&&matchr(lmistr("array"),a->lv[1]))return readbin(name);
+	if(a->c>1&&matchr(lmistr("csv"  ),a->lv[1]))return readcsvfile(name,l_drop(lmn(2),a));
 	if(has_suffix(name->sv,".gif"))return n_readgif(self,a);
 	if(has_suffix(name->sv,".wav"))return n_readwav(self,a);
 	return n_read(self,a);
@@ -38,17 +46,51 @@ lv*n_writedeck(lv*self,lv*a){
 	lv*path=ls(l_first(a));int html=0;if(has_suffix(path->sv,".html")){html=1;}
 	lv*v=deck_write(a->c<2?NONE:a->lv[1],html);if(v->c<1)return NONE;return n_write(self,lml2(path,v));
 }
-lv*runstring(char*t,lv*env){
-	lv* prog=parse(t);if(perr())return fprintf(stderr,"(%d:%d) %s\n",par.r+1,par.c+1,par.error),NONE;
-	return run(prog,env);
+// compiled scripts (lilt -c) are only run by lilt: modules in decks are always source, since web-decker can't read bytecode.
+int  is_code(char*t){return !strncmp(t,"%%BLK",5);}
+lv* code_read(lv*x){char f=0;lv*r=data_read("BLK",&f,x);r=r&&f=='0'?snap_read(r->sv,r->c,snap_base(NULL)):NULL;return snap_is(r,7)?r:NULL;}
+lv* code_write(lv*x){str s=str_new();if(snap_write(&s,x,snap_base(NULL)))return free(s.sv),NULL;lv*r=lmv(1);r->c=s.c,r->sv=s.sv;return data_write("BLK",'0',r);}
+lv*runstring(char*t,char*name,lv*env){
+	lv* prog=is_code(t)?code_read(lmcstr(t)):parse(t);if(!prog)return fprintf(ERR,"invalid compiled code in '%s'\n",name),NONE;
+	if(!is_code(t)&&perr())return fprintf(ERR,"(%d:%d) %s\n",par.r+1,par.c+1,par.error),NONE;
+	prog->a=lmcstr(name);return run(prog,env);
 }
 lv*runfile(char*path,lv*env){
-	struct stat st;if(stat(path,&st)){fprintf(stderr,"unable to open '%s'\n",path);return NONE;}
-	return runstring(n_read(NULL,l_list(lmcstr(path)))->sv,env);
+	struct stat st;if(stat(path,&st)){fprintf(ERR,"unable to open '%s'\n",path);return NONE;}
+	return runstring(n_read(NULL,l_list(lmcstr(path)))->sv,path,env);
+}
+
+// Profiler
+
+typedef struct{char*stack;long n;}prof_entry;
+prof_entry*prof=NULL;int prof_count=0,prof_size=0,prof_every=1000,prof_left=1000;char*prof_path=NULL;
+void prof_frame(str*s,lv*b,int pc){ // "name:row" for an active block; anonymous blocks are shown as "?"
+	if(s->c)str_addc(s,';');char*n=b->a&&lis(b->a)?b->a->sv:"?";
+	for(int z=0;n[z];z++)str_addc(s,n[z]==' '||n[z]==';'?'_':n[z]);
+	int row=blk_rowat(b,MAX(0,pc-1));if(row>=0){char t[32];str_add(s,t,snprintf(t,sizeof(t),":%d",row+1));}
+}
+void prof_sample(void){
+	if((prof_left-=100)>0)return;prof_left=prof_every;str s=str_new();
+	for(int z=0;z<gc.ss;z++){pstate*p=&gc.st[z];EACH(i,p->t)prof_frame(&s,p->t->lv[i],p->pcs.iv[i]);}
+	EACH(i,state.t)prof_frame(&s,state.t->lv[i],state.pcs.iv[i]);str_term(&s);
+	if(!prof_size)prof=calloc(prof_size=256,sizeof(prof_entry));
+	unsigned h=2166136261u;for(char*c=s.sv;*c;c++)h=(h^(unsigned char)*c)*16777619u;
+	int i=h&(prof_size-1);while(prof[i].stack&&strcmp(prof[i].stack,s.sv))i=(i+1)&(prof_size-1);
+	if(prof[i].stack){prof[i].n++;free(s.sv);return;}prof[i]=(prof_entry){s.sv,1};
+	if(++prof_count*2<prof_size)return;prof_entry*o=prof;int os=prof_size;prof=calloc(prof_size*=2,sizeof(prof_entry));
+	for(int z=0;z<os;z++)if(o[z].stack){
+		h=2166136261u;for(char*c=o[z].stack;*c;c++)h=(h^(unsigned char)*c)*16777619u;
+		i=h&(prof_size-1);while(prof[i].stack)i=(i+1)&(prof_size-1);prof[i]=o[z];
+	}free(o);
+}
+void prof_write(void){ // collapsed stacks, one "frame;frame;frame count" per line, as consumed by flamegraph.pl
+	FILE*f=fopen(prof_path,"w");if(!f){fprintf(stderr,"unable to write profile '%s'\n",prof_path);return;}
+	for(int z=0;z<prof_size;z++)if(prof[z].stack)fprintf(f,"%s %ld\n",prof[z].stack,prof[z].n);fclose(f);
 }
+void stats_write(void){str s=str_new();show(&s,workspace(),1);fprintf(stderr,"%s\n",lmstr(s)->sv);} // -s
 lv* print_array(lv*arr,FILE*out){array a=unpack_array(arr);for(int z=0;z<a.size;z++)fputc(0xFF&(int)array_get_raw(a,z),out);return arr;}
-lv*n_print(lv*self,lv*a){(void)self;return a->c==1&&array_is(a->lv[0])?print_array(l_first(a),stdout):n_printf(a,1,stdout);}
-lv*n_error(lv*self,lv*a){(void)self;return a->c==1&&array_is(a->lv[0])?print_array(l_first(a),stderr):n_printf(a,1,stderr);}
+lv*n_print(lv*self,lv*a){(void)self;return a->c==1&&array_is(a->lv[0])?print_array(l_first(a),OUT):n_printf(a,1,OUT);}
+lv*n_error(lv*self,lv*a){(void)self;return a->c==1&&array_is(a->lv[0])?print_array(l_first(a),ERR):n_printf(a,1,ERR);}
 
 extern char **environ;
 
@@ -61,7 +103,7 @@ lv* n_save (lv*self,lv*z){(void)self,(void)z;return NONE;}
 lv* n_play (lv*self,lv*z){(void)self;lv*x=l_first(z);return x;}
 lv* n_show(lv*self,lv*a){
 	(void)self;str s=str_new();EACH(z,a){if(z)str_addc(&s,' ');show(&s,a->lv[z],a->c==1);}
-	printf("%s\n",lmstr(s)->sv);return l_first(a);
+	fprintf(OUT,"%s\n",lmstr(s)->sv);return l_first(a);
 }
 lv*interface_app(lv*self,lv*i,lv*x){
 	if(!x&&lis(i)){
@@ -72,7 +114,7 @@ lv*interface_app(lv*self,lv*i,lv*x){
 
 // Environment
 
-lv*n_import(lv*self,lv*a); // forward ref
+lv*n_import(lv*self,lv*a);lv*n_pmap(lv*self,lv*a); // forward refs
 lv* globals(void){
 	lv*env=lmenv(NULL);
 	dset(env,lmistr("show"     ),lmnat(n_show,NULL));
@@ -87,13 +129,16 @@ lv* globals(void){
 	dset(env,lmistr("shell"    ),lmnat(n_shell,NULL));
 	dset(env,lmistr("eval"     ),lmnat(n_eval,NULL));
 	dset(env,lmistr("import"   ),lmnat(n_import,NULL));
+	dset(env,lmistr("pmap"     ),lmnat(n_pmap,NULL));
 	dset(env,lmistr("random"   ),lmnat(n_random,NULL));
+	dset(env,lmistr("memo"     ),lmnat(n_memo,NULL));
 	dset(env,lmistr("array"    ),lmnat(n_array,NULL));
 	dset(env,lmistr("image"    ),lmnat(n_image,NULL));
 	dset(env,lmistr("sound"    ),lmnat(n_sound,NULL));
 	dset(env,lmistr("readcsv"  ),lmnat(n_readcsv,NULL));
 	dset(env,lmistr("writecsv" ),lmnat(n_writecsv,NULL));
 	dset(env,lmistr("readxml"  ),lmnat(n_readxml,NULL));
+	dset(env,lmistr("census"   ),lmnat(n_census,NULL));
 	dset(env,lmistr("writexml" ),lmnat(n_writexml,NULL));
 	dset(env,lmistr("readdeck" ),lmnat(n_readdeck,NULL));
 	dset(env,lmistr("writedeck"),lmnat(n_writedeck,NULL));
@@ -102,36 +147,214 @@ lv* globals(void){
 }
 lv*n_import(lv*self,lv*a){
 	lv*file=n_read(self,a);if(!file->c)return NONE;
-	lv*prog=parse(ls(file)->sv);if(perr())return NONE;
-	lv*root=lmenv(globals());pushstate(root),issue(root,prog);
-	int c=0;while(running()){runop(),c++;if(c%100==0)lv_collect();}
+	lv*prog=is_code(file->sv)?code_read(file):parse(file->sv);if(!prog||(!is_code(file->sv)&&perr()))return NONE;
+	lv*root=lmenv(globals());pushstate(root),issue(root,prog);prog->a=lmcstr(ls(l_first(a))->sv);
+	int c=0;while(running()){runop(),c++;if(c%100==0){lv_collect();if(run_hook)run_hook();}}
 	DMAP(r,root,root->lv[z]);return popstate(),r;
 }
 
-// Entrypoint
+// Snapshots
 
-int main(int argc,char**argv){
-	init_interns();
-	lv* env=globals();
+lv* globals_read(char*b,int n){lv*r=snap_read(b,n,snap_base(globals()));return snap_is(r,8)?r:NULL;} // the global environment from a snapshot, or NULL
+lv* image_load(char*path){
+	FILE*f=fopen(path,"rb");if(!f)return NULL;fseek(f,0,SEEK_END);long n=ftell(f);fseek(f,0,SEEK_SET);
+	char*b=malloc(n+1);lv*r=fread(b,1,n,f)==(size_t)n?globals_read(b,n):NULL;fclose(f),free(b);return r;
+}
+char* globals_write(str*s,lv*env){
+	// args and env describe this process in particular, so they are left out (and re-bound on load):
+	lv*k[]={lmistr("args"),lmistr("env")},*v[2];for(int z=0;z<2;z++)v[z]=dget(env,k[z]),dset(env,k[z],NONE);
+	// natives and interfaces are only saved by the name of the built-in global they are still bound to:
+	lv*g=globals(),*base=snap_base(NULL);EACH(z,g){lv*x=dget(env,g->kv[z]),*y=g->lv[z];if(x&&(x->t==6||x->t==9)&&x->t==y->t&&x->f==y->f)dset(base,g->kv[z],x);}
+	char*err=snap_write(s,env,base);for(int z=0;z<2;z++)dset(env,k[z],v[z]);return err;
+}
+void image_save(char*path,lv*env){
+	str s=str_new();char*err=globals_write(&s,env);
+	if(err){fprintf(stderr,"%s.\n",err);exit(1);}
+	FILE*f=fopen(path,"wb");if(!f||fwrite(s.sv,1,s.c,f)!=(size_t)s.c){fprintf(stderr,"unable to write image '%s'\n",path);exit(1);}fclose(f),free(s.sv);
+}
+void code_save(char*path){ // compile FILE.lil to bytecode, written alongside it as FILE.lilb
+	struct stat st;if(stat(path,&st)){fprintf(stderr,"unable to open '%s'\n",path);exit(1);}
+	lv*prog=parse(n_read(NULL,l_list(lmcstr(path)))->sv);if(perr())fprintf(stderr,"(%d:%d) %s\n",par.r+1,par.c+1,par.error),exit(1);
+	prog->a=lmcstr(path);lv*r=code_write(prog);if(!r)fprintf(stderr,"unable to compile '%s'\n",path),exit(1);
+	char out[4096];snprintf(out,sizeof(out),"%sb",path);
+	FILE*f=fopen(out,"wb");if(!f||fwrite(r->sv,1,r->c,f)!=(size_t)r->c){fprintf(stderr,"unable to write '%s'\n",out);exit(1);}fclose(f);
+}
+
+// Jobs
+
+void bind_args(lv*env,int argc,char**argv){
 	lv* a=lml(argc);for(int z=0;z<argc;z++)a->lv[z]=lmutf8(argv[z]);
 	dset(env,lmistr("args"),a);
 	dset(env,lmistr("env"),env_enumerate());
-	char*home=getenv("LIL_HOME");if(home){
-		struct dirent*find;DIR*dir=opendir(home);if(dir){while((find=readdir(dir))){
-			char path[4096];snprintf(path,sizeof(path),"%s/%s",home,find->d_name);
-			if(has_suffix(path,".lil"))runfile(path,env);
-		}}closedir(dir);
+}
+void home_load(lv*env){ // run every script in LIL_HOME, if set
+	char*home=getenv("LIL_HOME");if(!home)return;
+	struct dirent*find;DIR*dir=opendir(home);if(!dir)return;while((find=readdir(dir))){
+		char path[4096];snprintf(path,sizeof(path),"%s/%s",home,find->d_name);
+		if(has_suffix(path,".lil")||has_suffix(path,".lilb"))runfile(path,env);
+	}closedir(dir);
+}
+char*job_image=NULL;int job_image_size=0; // if set, jobs start from this snapshot of the globals instead of running LIL_HOME scripts
+int lilt_job(int argc,char**argv,FILE*out,FILE*err){
+	// equivalent to 'lilt FILE ARGS...' for argv={"lilt",FILE,ARGS...}, but run on the calling thread, writing to out and err.
+	// the interpreter gets a fresh heap, which is freed again afterwards. returns the argument to exit[], if called, or 0.
+	jmp_buf trap;out_stream=out,err_stream=err,exit_trap=&trap,exit_code=0;init_interns();
+	if(!setjmp(trap)){
+		lv*env=job_image?globals_read(job_image,job_image_size):NULL;int home=!env;if(home)env=globals();
+		bind_args(env,argc,argv);if(home)home_load(env);if(argc>1)runfile(argv[1],env);
+	}fflush(out),fflush(err);out_stream=err_stream=NULL,exit_trap=NULL;lv_reset();return exit_code;
+}
+int cores(void){
+	#ifdef _SC_NPROCESSORS_ONLN
+	return MAX(1,sysconf(_SC_NPROCESSORS_ONLN));
+	#else
+	return 4;
+	#endif
+}
+#define MAX_THREADS (4*cores()) // the most threads worth running at once
+int run_threads(int n,void*(*f)(void*),char*args,size_t size){
+	// run f on n threads at once, each given its own element of args. if some threads can't be started, their elements
+	// are run on new threads once the others finish. returns how many elements were run: fewer than n if no thread starts.
+	pthread_t*w=calloc(n,sizeof(pthread_t));pthread_attr_t a;int done=0;
+	pthread_attr_init(&a),pthread_attr_setstacksize(&a,8<<20); // as much as a typical main thread; parsing is recursive
+	while(done<n){
+		int c=0;while(done+c<n&&!pthread_create(&w[c],&a,f,args?args+(done+c)*size:NULL))c++;
+		for(int z=0;z<c;z++)pthread_join(w[z],NULL);if(!c)break;done+=c;
+	}pthread_attr_destroy(&a),free(w);return done;
+}
+typedef struct{int argc;char**argv,*out,*err;size_t on,en;int code;}job;
+job*jobs=NULL;int job_count=0,job_next=0;pthread_mutex_t job_lock=PTHREAD_MUTEX_INITIALIZER;
+void* job_worker(void*arg){
+	(void)arg;while(1){
+		pthread_mutex_lock(&job_lock);int i=job_next++;pthread_mutex_unlock(&job_lock);if(i>=job_count)return NULL;
+		job*j=&jobs[i];FILE*o=open_memstream(&j->out,&j->on),*e=open_memstream(&j->err,&j->en);
+		j->code=lilt_job(j->argc,j->argv,o,e);fclose(o),fclose(e);
+	}
+}
+int jobs_run(char*path,int workers,lv*env){
+	// each line of the file at path (or stdin, for "-") is a job 'FILE ARGS...', run as if by 'lilt FILE ARGS...'
+	// on a pool of worker threads. the output of each job is written in order once all are done. returns 1 if any
+	// job exited with a nonzero code (each such code is reported on stderr), 1 if path can't be read or no worker
+	// thread can be started, otherwise 0. there are at most MAX_THREADS workers.
+	FILE*f=strcmp(path,"-")?fopen(path,"rb"):stdin;if(!f)return fprintf(stderr,"unable to open '%s'\n",path),1;
+	str t=str_new();char b[4096];size_t n;while((n=fread(b,1,sizeof(b),f)))str_add(&t,b,n);if(f!=stdin)fclose(f);str_term(&t);
+	for(char*line=strtok(t.sv,"\r\n");line;line=strtok(NULL,"\r\n")){
+		char**argv=calloc(strlen(line)/2+3,sizeof(char*));int argc=0;argv[argc++]="lilt";
+		for(char*c=line;*c;){while(*c==' '||*c=='\t')*c++='\0';if(*c)argv[argc++]=c;while(*c&&*c!=' '&&*c!='\t')c++;}
+		if(argc<2||argv[1][0]=='#'){free(argv);continue;}
+		jobs=realloc(jobs,(job_count+1)*sizeof(job));jobs[job_count++]=(job){argc,argv,NULL,NULL,0,0,0};
+	}
+	// the main interpreter has already run LIL_HOME (or loaded an image), so every job may start from a snapshot of its globals:
+	str s=str_new();if(!globals_write(&s,env))job_image=s.sv,job_image_size=s.c;int r=0;
+	// the workers take jobs from a shared queue, so every job runs as long as any one of them starts:
+	if(job_count&&!run_threads(MAX(1,MIN(MIN(workers,job_count),MAX_THREADS)),job_worker,NULL,0))fprintf(stderr,"unable to start a worker thread\n"),r=1;
+	for(int z=0;z<job_count;z++){
+		job*j=&jobs[z];fwrite(j->out,1,j->on,stdout),fwrite(j->err,1,j->en,stderr);
+		if(j->code)fprintf(stderr,"job %d (%s) exited with %d\n",z+1,j->argv[1],j->code),r=1;
+		free(j->out),free(j->err),free(j->argv);
+	}fflush(stdout);return free(jobs),free(s.sv),free(t.sv),r;
+}
+
+// Parallel map
+
+void pmap_scan(lv*b,lv*loc,lv*get,lv*set){ // the names a block, and any code nested within it, binds locally, reads, and writes
+	for(int z=0,o;z<blk_here(b);z+=oplens[o]){
+		o=blk_getb(b,z);if(o!=LIT&&o!=GET&&o!=SET&&o!=LOC&&o!=AMEND)continue;lv*k=blk_getimm(b,blk_geti(b,z+1));
+		if(o==GET)dset(get,k,ONE);
+		if(o==SET||(o==AMEND&&lis(k)))dset(set,k,ONE);
+		if(o==LOC)dset(loc,k,ONE);
+		if(o==LIT&&z+5<blk_here(b)&&blk_getb(b,z+5)==EACH)EACH(i,k)dset(loc,k->lv[i],ONE); // the names of an each loop
+		if(o==LIT&&lion(k)){dset(loc,lmcstr(k->sv),ONE);EACH(i,k)dset(loc,k->lv[i],ONE);pmap_scan(k->b,loc,get,set);}
+		if(o==LIT&&k->t==7)pmap_scan(k,loc,get,set);
 	}
+}
+char* pmap_deps(lv*f,lv*deps){
+	// a function run by pmap[] may refer only to its own variables, or to other functions which follow the same rules (collected in deps).
+	// anything else in its closure- global data, natives, interfaces- belongs to the calling thread, so the function is refused.
+	static LIL_LOCAL char err[256];lv*loc=lmd(),*get=lmd(),*set=lmd();
+	EACH(z,f){lv*n=f->lv[z];dset(loc,n->sv[0]=='.'?lmcstr(n->sv+3):n,ONE);}pmap_scan(f->b,loc,get,set);
+	EACH(z,set){lv*n=set->kv[z];if(!dget(loc,n)&&f->env&&env_find(f->env,n))return snprintf(err,sizeof(err),"pmap[] functions may not assign to the variable '%s'",n->sv),err;}
+	EACH(z,get){
+		lv*n=get->kv[z],*v=dget(loc,n)||!f->env?NULL:env_find(f->env,n),*d=v?dget(deps,n):NULL;if(!v||d==v)continue;
+		if(d||!lion(v))return snprintf(err,sizeof(err),"pmap[] functions may not refer to the variable '%s'",n->sv),err;
+		dset(deps,n,v);char*e=pmap_deps(v,deps);if(e)return e;
+	}return NULL;
+}
+lv* pmap_detach(lv*f,lv*r){ // a copy of f without its closure (r=NULL), or release such a copy
+	if(r){r->sv=NULL,r->lv=NULL,r->c=0;return NULL;}r=lmv(5);r->sv=f->sv,r->lv=f->lv,r->c=f->c,r->s=f->s,r->b=f->b;return r;
+}
+typedef struct{char*in,*out;int in_size,out_size;}pmap_chunk;
+void* pmap_worker(void*arg){
+	// a chunk is (f,deps,values), snapshotted: map f over the values in this thread's own heap, and snapshot the results.
+	pmap_chunk*c=arg;init_interns();lv*p=snap_read(c->in,c->in_size,snap_base(NULL)),*root=lmenv(NULL),*env=lmenv(root);
+	if(lil(p)&&p->c==3&&lion(p->lv[0])&&lid(p->lv[1])&&lil(p->lv[2])){
+		lv*f=p->lv[0],*deps=p->lv[1];f->env=root;EACH(z,deps)deps->lv[z]->env=root,env_local(root,deps->kv[z],deps->lv[z]);
+		env_local(env,lmistr("f"),f),env_local(env,lmistr("x"),p->lv[2]);lv*r=run(parse("f@x"),env);
+		str s=str_new();if(lil(r)&&!snap_write(&s,r,snap_base(NULL))){c->out=s.sv,c->out_size=s.c;}else{free(s.sv);}
+	}lv_reset();return NULL;
+}
+lv*n_pmap(lv*self,lv*a){
+	// pmap[f x n]: f[v] for each value v of x, as in f@x, split into n chunks (one per core by default, at most MAX_THREADS)
+	// mapped on as many threads.
+	(void)self;lv*f=l_first(a),*x=a->c>1?a->lv[1]:NONE,*keys=lid(x)?x:NULL,*deps=lmd();if(!lion(f))return NONE;
+	char*e=pmap_deps(f,deps);if(e)return fprintf(ERR,"%s.\n",e),NONE;
+	x=ll(x);int n=a->c>2?ln(a->lv[2]):cores();n=MAX(1,MIN(MIN(n,x->c),MAX_THREADS));
+	lv*df=pmap_detach(f,NULL),*dd=lmd();EACH(z,deps)dset(dd,deps->kv[z],pmap_detach(deps->lv[z],NULL));
+	pmap_chunk*c=calloc(n,sizeof(pmap_chunk));for(int z=0;z<n&&!e;z++){
+		int lo=(long long)x->c*z/n,hi=(long long)x->c*(z+1)/n;lv*v=lml(hi-lo);for(int i=lo;i<hi;i++)v->lv[i-lo]=x->lv[i];
+		str s=str_new();e=snap_write(&s,lml3(df,dd,v),snap_base(NULL));c[z].in=s.sv,c[z].in_size=s.c;
+	}
+	pmap_detach(f,df);EACH(z,dd)pmap_detach(NULL,dd->lv[z]);
+	if(!e&&run_threads(n,pmap_worker,(char*)c,sizeof(pmap_chunk))<n)e="pmap[] was unable to start a thread";
+	lv*r=lml(0);for(int z=0;z<n;z++){
+		lv*v=e||!c[z].out?NULL:snap_read(c[z].out,c[z].out_size,snap_base(NULL));
+		if(!lil(v)&&!e)e="pmap[] results must be ordinary values";if(v)EACH(i,v)ll_add(r,v->lv[i]);free(c[z].in),free(c[z].out);
+	}free(c);if(e)return fprintf(ERR,"%s.\n",e),NONE;
+	if(keys){lv*d=lmd();EACH(z,keys)dset(d,keys->kv[z],r->lv[z]);return d;}return r;
+}
+
+// Entrypoint
+
+int main(int argc,char**argv){
+	init_interns();
+	lv* env=globals();char*image=NULL;
+	for(int z=1;z<argc-1;z++)if(!strcmp(argv[z],"-i"))image=argv[z+1];
+	if(image){env=image_load(image);if(!env)fprintf(stderr,"unable to load image '%s'\n",image),exit(1);}
+	bind_args(env,argc,argv);if(!image)home_load(env);
 	int repl=1;for(int z=1;z<argc;z++){
 		if(!strcmp(argv[z],"-h")){repl=0;
-			printf("usage: %s [FILE.lil...] [-e EXPR...]\nif present, execute a FILE and exit\n",argv[0]);
+			printf("usage: %s [-i IMAGE] [-p PROFILE] [-s] [-c FILE.lil] [-j N JOBS] [FILE.lil...] [-e EXPR...] [-w IMAGE]\nif present, execute a FILE and exit\n",argv[0]);
+			printf("-c : compile FILE.lil to bytecode, saved as FILE.lilb, which can be run or imported in its place\n");
 			printf("-e : evaluate STRING and exit\n-h : display this information\n");
+			printf("-i : start from the global variables saved in IMAGE, instead of running LIL_HOME scripts\n");
+			printf("-j : run each line of JOBS, 'FILE ARGS...', as if by 'lilt FILE ARGS...', on N threads; output is kept in order\n");
+			printf("-p : sample the call stack every %d ops, and write collapsed stacks to PROFILE at exit\n",prof_every);
+			printf("-s : print runtime statistics (as in sys.workspace) on stderr at exit\n");
+			printf("-w : save the global variables, as they stand, to IMAGE\n");
+		}
+		else if(!strcmp(argv[z],"-i")){z++;}
+		else if(!strcmp(argv[z],"-w")){repl=0;
+			if(z+1>=argc)fprintf(stderr,"no image path specified.\n"),exit(1);
+			image_save(argv[++z],env);
+		}
+		else if(!strcmp(argv[z],"-c")){repl=0;
+			if(z+1>=argc)fprintf(stderr,"no script path specified.\n"),exit(1);
+			code_save(argv[++z]);
+		}
+		else if(!strcmp(argv[z],"-j")){
+			if(z+2>=argc)fprintf(stderr,"no worker count and jobs file specified.\n"),exit(1);
+			if(jobs_run(argv[z+2],atoi(argv[z+1]),env))exit(1);z+=2;repl=0;
+		}
+		else if(!strcmp(argv[z],"-s")){atexit(stats_write);}
+		else if(!strcmp(argv[z],"-p")){
+			if(z+1>=argc)fprintf(stderr,"no profile path specified.\n"),exit(1);
+			prof_path=argv[++z],run_hook=prof_sample;atexit(prof_write);
 		}
 		else if(!strcmp(argv[z],"-e")){repl=0;
 			if(z+1>=argc)fprintf(stderr,"no expression specified.\n"),exit(1);
-			runstring(argv[z+1],env),z++;
+			runstring(argv[z+1],"-e",env),z++;
 		}
-		else if(has_suffix(argv[z],".lil")){repl=0;runfile(argv[z],env),z++;}
+		else if(has_suffix(argv[z],".lil")||has_suffix(argv[z],".lilb")){repl=0;runfile(argv[z],env),z++;}
 	}if(!repl){exit(0);}
 	while(1){
 		char*line=bestlineWithHistory(" ","lilt");
@@ -139,5 +362,5 @@ int main(int argc,char**argv){
 		lv*prog=parse(line);free(line);
 		if(perr()){for(int z=0;z<par.c+2;z++)printf(" ");printf("^\n%s\n",par.error);}
 		else{lv*x=run(prog,env);dset(env,lmistr("_"),x);debug_show(x);}
-	}
+	}return 0;
 }
@@ -281,9 +281,9 @@ dyad={
 				}if(m&=y[h]=='"')h++
 			}
 			else if(t=='f'||t=='c'||t=='C'){
-				v=lmn(0);let p=10,s=(y[h]=='-')?(h++,-1):1; if(t=='c'&&m&&y[h]=='$')h++
-				m&=id(y[h])||y[h]=='.';  while(hn()&&id(y[h]))v.v=v.v*10+(+y[h++])
-				m&&hn()&&y[h]=='.'&&h++; while(hn()&&id(y[h]))v.v+=(+y[h++])/p,p*=10;v.v*=s
+				const s=(y[h]=='-')?(h++,-1):1; if(t=='c'&&m&&y[h]=='$')h++
+				m&=id(y[h])||y[h]=='.';  const ds=h;while(hn()&&id(y[h]))h++
+				m&&hn()&&y[h]=='.'&&h++; while(hn()&&id(y[h]))h++;v=lmn(s*(+y.slice(ds,h)||0))
 			}
 			else if(t=='r'||t=='o'){
 				let cc=x.slice(f,f+(d||1));v=lms(''),f+=(d||1);
@@ -394,6 +394,24 @@ n_eval=([x,y,extend])=>{
 		issue(env_bind(extend&&lb(extend)?getev():null,yy.k.map(ls),lml(yy.v)),prog)
 	}catch(e){dset(r,lms('error'),lms(e.x)),dset(r,lms('errorpos'),lml([lmn(e.r),lmn(e.c)]))};return r
 }
+let memo_id=0;const memo_ids=new WeakMap()
+memo_key=x=>lin(x)?'n'+x.v: lis(x)?'s'+JSON.stringify(x.v): lil(x)?'['+x.v.map(memo_key).join(',')+']':
+	lid(x)?'{'+x.k.map((k,i)=>memo_key(k)+':'+memo_key(x.v[i])).join(',')+'}':
+	lit(x)?'<'+tab_cols(x).map(k=>JSON.stringify(k)+':'+tab_get(x,k).map(memo_key).join(',')).join(';')+'>':
+	'#'+(memo_ids.get(x)||(memo_ids.set(x,++memo_id),memo_id)) // functions and interfaces match only themselves
+n_memo=([f,n])=>{
+	// the cache is a Map in recency order: hits are moved to the end, and evictions come from the front.
+	if(linat(f)&&f.memo){const m=f.memo;return lmd(['hits','misses','size','limit'].map(lms),[m.hits,m.misses,m.cache.size,m.limit].map(lmn))}
+	if(!lion(f)&&!linat(f))return NONE;n=n?0|ln(n):0
+	const m={hits:0,misses:0,limit:n<1?1024:min(n,1<<24),cache:new Map()}
+	const store=([k,x])=>{k=ls(k),m.cache.delete(k),m.cache.set(k,x);if(m.cache.size>m.limit)m.cache.delete(m.cache.keys().next().value);return x}
+	const r=lmnat(a=>{
+		const k=memo_key(lml(a)),x=m.cache.get(k);if(x){m.hits++,m.cache.delete(k),m.cache.set(k,x);return x}
+		m.misses++;const b=lmblk() // a miss calls f, as eval[] does, by issuing a block which then hands the result to store() along with the key
+		blk_lit(b,f),blk_lit(b,lml(a)),blk_op(b,op.CALL),blk_opa(b,op.BUND,2),blk_lit(b,lmnat(store)),blk_op(b,op.SWAP),blk_op(b,op.CALL)
+		issue(getev(),b);return lms(k)
+	});r.memo=m;return r
+}
 triad={
 	'@orderby': (col,tab,order_dir)=>{
 		const lex_list=(x,y,a,ix)=>{
@@ -433,18 +451,22 @@ triad={
 
 findop=(n,prims)=>Object.keys(prims).indexOf(n), as_enum=x=>x.split(',').reduce((x,y,i)=>{x[y]=i;return x},{})
 let tnames=0;tempname=_=>lms(`@t${tnames++}`)
-op=as_enum('JUMP,JUMPF,LIT,DUP,DROP,SWAP,OVER,BUND,OP1,OP2,OP3,GET,SET,LOC,AMEND,TAIL,CALL,BIND,ITER,EACH,NEXT,COL,IPRE,IPOST,FIDX,FMAP')
-oplens=   [ 3   ,3    ,3  ,1  ,1   ,1   ,1   ,3   ,3  ,3  ,3  ,3  ,3  ,3  ,3    ,1   ,1   ,1   ,1   ,3   ,3   ,1  ,3   ,3    ,3   ,3    ]
+op=as_enum('JUMP,JUMPF,LIT,DUP,DROP,SWAP,OVER,BUND,OP1,OP2,OP3,GET,SET,LOC,AMEND,TAIL,CALL,BIND,ITER,EACH,NEXT,COL,IPRE,IPOST,FIDX,FMAP,RANGE')
+oplens=   [ 5   ,5    ,5  ,1  ,1   ,1   ,1   ,5   ,5  ,5  ,5  ,5  ,5  ,5  ,5    ,1   ,1   ,1   ,1   ,5   ,5   ,1  ,5   ,5    ,5   ,5   ,5    ]
 blk_addb=(x,n  )=>x.b.push(0xFF&n)
 blk_here=(x    )=>x.b.length
 blk_setb=(x,i,n)=>x.b[i]=0xFF&n
 blk_getb=(x,i  )=>0xFF&x.b[i]
-blk_adds=(x,n  )=>{blk_addb(x,n>>8),blk_addb(x,n)}
-blk_sets=(x,i,n)=>{blk_setb(x,i,n>>8),blk_setb(x,i+1,n)}
-blk_gets=(x,i  )=>0xFFFF&(blk_getb(x,i)<<8|blk_getb(x,i+1))
+blk_addi=(x,n  )=>{for(let z=24;z>=0;z-=8)blk_addb(x,n>>z)}
+blk_seti=(x,i,n)=>{for(let z=0;z<4;z++)blk_setb(x,i+z,n>>(24-8*z))}
+blk_geti=(x,i  )=>blk_getb(x,i)<<24|blk_getb(x,i+1)<<16|blk_getb(x,i+2)<<8|blk_getb(x,i+3)
 blk_op  =(x,o  )=>{blk_addb(x,o);if(o==op.COL)blk_addb(x,op.SWAP)}
-blk_opa =(x,o,i)=>{blk_addb(x,o),blk_adds(x,i);return blk_here(x)-2}
-blk_imm =(x,o,k)=>{let i=x.locals.findIndex(x=>match(x,k));if(i==-1)i=x.locals.length,x.locals.push(k);blk_opa(x,o,i)}
+blk_opa =(x,o,i)=>{blk_addb(x,o),blk_addi(x,i);return blk_here(x)-4}
+blk_imm =(x,o,k)=>{ // numbers and strings are pooled through a map, anything else by a linear scan
+	const h=lin(k)?'n'+k.v: lis(k)?'s'+k.v: null;if(h!=null&&!x.pool)x.pool=new Map()
+	let i=h!=null?(x.pool.has(h)?x.pool.get(h):-1): x.locals.findIndex(x=>match(x,k))
+	if(i==-1){i=x.locals.length,x.locals.push(k);if(h!=null)x.pool.set(h,i)}blk_opa(x,o,i)
+}
 blk_op1 =(x,n)=>blk_opa(x,op.OP1,findop(n,monad))
 blk_op2 =(x,n)=>blk_opa(x,op.OP2,findop(n,dyad ))
 blk_op3 =(x,n)=>blk_opa(x,op.OP3,findop(n,triad))
@@ -455,19 +477,27 @@ blk_get =(x,n)=>blk_imm(x,op.GET,n)
 blk_getimm=(x,i)=>x.locals[i]
 blk_cat=(x,y)=>{
 	let z=0,base=blk_here(x);while(z<blk_here(y)){
-		const b=blk_getb(y,z);if(b==op.LIT||b==op.GET||b==op.SET||b==op.LOC||b==op.AMEND){blk_imm(x,b,blk_getimm(y,blk_gets(y,z+1)))}
-		else if(b==op.JUMP||b==op.JUMPF||b==op.EACH||b==op.NEXT||b==op.FIDX){blk_opa(x,b,blk_gets(y,z+1)+base)}
+		const b=blk_getb(y,z);if(b==op.LIT||b==op.GET||b==op.SET||b==op.LOC||b==op.AMEND){blk_imm(x,b,blk_getimm(y,blk_geti(y,z+1)))}
+		else if(b==op.JUMP||b==op.JUMPF||b==op.EACH||b==op.NEXT||b==op.FIDX){blk_opa(x,b,blk_geti(y,z+1)+base)}
 		else{for(let i=0;i<oplens[b];i++)blk_addb(x,blk_getb(y,z+i))}z+=oplens[b]
 	}
 }
-blk_loop=(b,names,f)=>{
-	blk_op(b,op.ITER);const head=blk_here(b);blk_lit(b,names);const each=blk_opa(b,op.EACH,0)
-	f(),blk_opa(b,op.NEXT,head),blk_sets(b,each,blk_here(b))
+blk_each=(b,names,f)=>{
+	const head=blk_here(b);blk_lit(b,names);const each=blk_opa(b,op.EACH,0)
+	f(),blk_opa(b,op.NEXT,head),blk_seti(b,each,blk_here(b))
+}
+blk_loop=(b,names,f)=>{blk_op(b,op.ITER),blk_each(b,names,f)}
+blk_range=(b,s)=>{ // an each loop over range y, x take range y or x drop range y needs no list: see lil.h
+	const n=blk_here(b);let p=-1,q=-1,m=0;for(let z=s;z<n;z+=oplens[blk_getb(b,z)])q=p,p=z;if(p<0)return 0
+	if(blk_getb(b,p)==op.OP2){const i=blk_geti(b,p+1);m=i==findop('take',dyad)?1: i==findop('drop',dyad)?2: 0;if(!m||q<0)return 0;p=q}
+	if(blk_getb(b,p)!=op.OP1||blk_geti(b,p+1)!=findop('range',monad))return 0
+	for(let z=s,o;z<n;z+=oplens[o]){o=blk_getb(b,z);if([op.JUMP,op.JUMPF,op.EACH,op.NEXT,op.FIDX].includes(o)&&blk_geti(b,z+1)>p)return 0}
+	b.b.length=p,blk_opa(b,op.RANGE,m);return 1
 }
 blk_end=x=>{
 	let z=0;while(z<blk_here(x)){
 		let b=blk_getb(x,z);z+=oplens[b];if(b!=op.CALL)continue
-		let t=1,i=z;while(i<blk_here(x)){if(blk_getb(x,i)!=op.JUMP){t=0;break}const a=blk_gets(x,i+1);if(a<=i){t=0;break}i=a}if(t)blk_setb(x,z-1,op.TAIL)
+		let t=1,i=z;while(i<blk_here(x)){if(blk_getb(x,i)!=op.JUMP){t=0;break}const a=blk_geti(x,i+1);if(a<=i){t=0;break}i=a}if(t)blk_setb(x,z-1,op.TAIL)
 	}return x
 }
 
@@ -484,11 +514,9 @@ parse=text=>{
 	const mcc='     xx x xxxx x          x xxx x                          x  x                             x x'
 	const esc={'\\':'\\','"':'"','n':'\n'}
 	const ne=_=>{const e=nc();return esc[e]?esc[e]: er(`Invalid escape character '\\${e}' in string.`)}
-	const nw=x=>{let v=+x;    while(id())v=(v*10)+(+nc());  return v} 
-	const nf=_=>{let v=0,p=10;while(id())v+=(+nc())/p,p*=10;return v}
 	const nn=(x,tr,tc,v,sign)=>{
 		if(x=='.'&&!id())return{t:'.',r:tr,c:tc}
-		if(x=='.')v=nf();else v=nw(x),v+=(text[i]=='.')?(nc(),nf()):0
+		const s=i-1;while(id())nc();if(x!='.'&&text[i]=='.'){nc();while(id())nc()}v=+text.slice(s,i)
 		return {t:'number',v:sign*v,r:tr,c:tc}
 	}
 	const tok=_=>{
@@ -571,24 +599,24 @@ parse=text=>{
 			const fin=[];let c=0,e=0,next=-1;expr(b);next=blk_opa(b,op.JUMPF,0);while(hasnext()){
 				if(match('elseif')){
 					if(e)er(`Expected 'end'.`)
-					if(!c)blk_lit(b,NONE);c=0;fin.push(blk_opa(b,op.JUMP,0)),blk_sets(b,next,blk_here(b)),expr(b),next=blk_opa(b,op.JUMPF,0);continue
+					if(!c)blk_lit(b,NONE);c=0;fin.push(blk_opa(b,op.JUMP,0)),blk_seti(b,next,blk_here(b)),expr(b),next=blk_opa(b,op.JUMPF,0);continue
 				}
 				if(match('else')){
 					if(e)er(`Expected 'end'.`)
-					if(!c)blk_lit(b,NONE);c=0,e=1;fin.push(blk_opa(b,op.JUMP,0)),blk_sets(b,next,blk_here(b)),next=-1;continue
+					if(!c)blk_lit(b,NONE);c=0,e=1;fin.push(blk_opa(b,op.JUMP,0)),blk_seti(b,next,blk_here(b)),next=-1;continue
 				}
 				if(match('end')){
-					if(!c)blk_lit(b,NONE);c=0;if(!e)fin.push(blk_opa(b,op.JUMP,0));if(next!=-1)blk_sets(b,next,blk_here(b));if(!e)blk_lit(b,NONE)
-					fin.map(x=>blk_sets(b,x,blk_here(b)));return
+					if(!c)blk_lit(b,NONE);c=0;if(!e)fin.push(blk_opa(b,op.JUMP,0));if(next!=-1)blk_seti(b,next,blk_here(b));if(!e)blk_lit(b,NONE)
+					fin.map(x=>blk_seti(b,x,blk_here(b)));return
 				}
 				if(c)blk_op(b,op.DROP);expr(b),c++
 			}
 		}
 		if(match('while')){
 			blk_lit(b,NONE);const head=blk_here(b);expr(b);const cond=blk_opa(b,op.JUMPF,0)
-			blk_op(b,op.DROP),iblock(b),blk_opa(b,op.JUMP,head),blk_sets(b,cond,blk_here(b));return
+			blk_op(b,op.DROP),iblock(b),blk_opa(b,op.JUMP,head),blk_seti(b,cond,blk_here(b));return
 		}
-		if(match('each')){const n=names('in','variable');expr(b),blk_loop(b,n,_=>iblock(b));return}
+		if(match('each')){const n=names('in','variable'),s=blk_here(b);expr(b);if(!blk_range(b,s))blk_op(b,op.ITER);blk_each(b,n,_=>iblock(b));return}
 		if(match('on')){
 			const n=name('function'),v=matchsp('.')&&matchsp('.')&&matchsp('.');let a=names('do','argument')
 			if(v&&a.length!=1)return er(`Variadic functions must take exactly one named argument.`);if(v)a=['...'+a[0]]
@@ -625,7 +653,7 @@ parse=text=>{
 			const func=tempname();blk_set(b,func),blk_op(b,op.DROP),expr(b)
 			let l=lmblk();blk_get(l,func),blk_op(l,op.SWAP);const fidx=blk_opa(l,op.FIDX,0)
 			blk_loop(l,['v'],_=>{blk_get(l,func),blk_get(l,lms('v')),blk_opa(l,op.BUND,1),blk_op(l,op.CALL)})
-			blk_sets(l,fidx,blk_here(l))
+			blk_seti(l,fidx,blk_here(l))
 			while(depth-->0){const t=tempname(),m=lmblk();blk_loop(m,[ls(t)],_=>{blk_get(m,t),blk_cat(m,l)}),l=m}
 			blk_cat(b,l);return
 		}const s=peek().v;if(findop(s,dyad)>=0&&({'symbol':1,'name':1})[peek().t]){next(),expr(b),blk_op2(b,s)}
@@ -640,6 +668,12 @@ env_setr =(e,n,x)=>{const k=ls(n);r=e.v.get(k);return r?e.v.set(k,x): e.p?env_se
 env_get  =(e,n  )=>env_getr(e,n)||NONE
 env_set  =(e,n,x)=>{const r=env_getr(e,n);r?env_setr(e,n,x):env_local(e,n,x)}
 env_bind =(e,k,v)=>{const r=lmenv(e); k.map((a,i)=>env_local(r,lms(a),v.v[i]||NONE));return r}
+range_source=(m,x,y)=>{ // the elements of range y, x take range y or x drop range y (m=0,1,2), for op.RANGE
+	if(!lin(y)||(x&&!lin(x))){const r=monad.range(y);return m==1?dyad.take(x,r): m==2?dyad.drop(x,r): r}
+	const n=max(0,0|ln(y)),k=x?0|ln(x):0;let s=0,c=n
+	if(m==1)c=abs(k),s=k<0&&n?mod(k,n):0;if(m==2)s=k>0?min(k,n):0,c=max(0,k>0?n-k:n+k)
+	return {t:'lst',v:null,c:c,n:m?n:-1,s:s}
+}
 const monadi=Object.values(monad), dyadi=Object.values(dyad), triadi=Object.values(triad), states=[]; let state=null
 pushstate=env=>{if(state){states.push(state)};state={e:[env],p:[],t:[],pcs:[]}}
 popstate =_=>{state=states.pop()}
@@ -662,7 +696,7 @@ docall=(f,a,tail)=>{
 }
 runop=_=>{
 	const b=getblock();if(!liblk(b))ret(state.t.pop())
-	const pc=getpc(),o=blk_getb(b,pc),imm=(oplens[o]==3?blk_gets(b,1+pc):0); setpc(pc+oplens[o])
+	const pc=getpc(),o=blk_getb(b,pc),imm=(oplens[o]>1?blk_geti(b,1+pc):0); setpc(pc+oplens[o])
 	switch(o){
 		case op.DROP :arg();break
 		case op.DUP  :{const a=arg();ret(a),ret(a);break}
@@ -690,9 +724,10 @@ runop=_=>{
 		case op.ITER :{const x=arg();ret(lil(x)?x:ld(x));ret(lid(x)?lmd():lml([]));break}
 		case op.FIDX :{const x=arg(),f=arg();if((lid(f)||lil(f)||lis(f))&&lil(x)){ret(lml(x.v.map(x=>l_at(f,x))));setpc(imm)}else{ret(x)};break}
 		case op.FMAP :{const x=arg(),f=monadi[imm];ret(lid(x)?lmd(x.k,x.v.map(f)):lml(ll(x).map(f)));break}
+		case op.RANGE:{const y=arg(),x=imm?arg():null;ret(range_source(imm,x,y)),ret(lml([]));break}
 		case op.EACH :{
-			const n=arg(),r=arg(),s=arg();if(count(r)==count(s)){setpc(imm),ret(r);break}
-			const z=count(r), v=lml([s.v[z],lid(s)?s.k[z]:lmn(z),lmn(z)]);
+			const n=arg(),r=arg(),s=arg();if(count(r)==(s.v?count(s):s.c)){setpc(imm),ret(r);break}
+			const z=count(r), i=lmn(z), v=lml([s.v?s.v[z]: s.n==-1?i: s.n?lmn(mod(s.s+z,s.n)): NONE,lid(s)?s.k[z]:i,i]);
 			state.e.push(env_bind(getev(),n,v)),ret(s),ret(r);break
 		}
 		case op.NEXT :{const v=arg(),r=arg(),s=arg();state.e.pop();if(lid(r))r.k.push(s.k[r.v.length]);r.v.push(v),ret(s),ret(r),setpc(imm);break}
@@ -716,8 +751,9 @@ n_writecsv=([x,y,d])=>{
 		})
 	});return lms(r)
 }
-n_readcsv=([x,y,d])=>{
-	let i=0,n=0, spec=y&&lis(y)?ls(y):null, text=count(x)?ls(x):'', r=lmt(); d=d?ls(d)[0]:','
+csv_num=/^-?(\d+\.?\d*|\.\d+)([eE][+-]?\d+)? *$/
+n_readcsv=([x,y,d,l])=>{
+	let i=0,n=0,rows=0, spec=y&&lis(y)?ls(y):null, text=count(x)?ls(x):'', r=lmt(); d=d?ls(d)[0]:',', l=l?max(-1,0|ln(l)):-1
 	const nv=_=>{let r='';while(text[i]&&text[i]!='\n'&&text[i]!=d)r+=text[i++];return r}, match=x=>text[i]==x?(i++,1):0
 	while(i<text.length&&text[i]!='\n'){
 		while(match(' '));const v=nv();if(!spec||(n<spec.length&&spec[n]!='_'))tab_set(r,v,[]);n++;if(match('\n'))break;while(match(' '));match(d)
@@ -725,19 +761,21 @@ n_readcsv=([x,y,d])=>{
 	while(spec&&n<spec.length){if(spec[n]!='_'){tab_set(r,'c'+n,[])};n++}
 	if(!spec)spec='s'.repeat(tab_cols(r).length)
 	let slots=0,slot=0;spec.split('').map(z=>{if(z!='_')slots++;});slots=min(slots,tab_cols(r).length),n=0
-	if(i>=text.length)return r;while(i<=text.length){
+	const infer=_=>{let slot=0;spec.split('').forEach(z=>{if(z=='_'||slot>=tab_cols(r).length)return;const c=tab_get(r,tab_cols(r)[slot++]);
+		if(z=='?'&&c.every(v=>!v.v.length||csv_num.test(v.v))&&c.some(v=>v.v.length))c.forEach((v,i)=>c[i]=lmn(parseFloat(v.v)||0))});return r}
+	if(i>=text.length)return infer();while(rows!=l&&i<=text.length){
 		while(match(' '));
 		let val='';if(match('"')){while(text[i]){if(match('"')){if(match('"')){val+='"'}else{break}}else{val+=text[i++]}}}else{val=nv()}
 		if(spec[n]&&spec[n]!='_'){
 			const k=tab_cols(r)[slot], x=(val[0]||'').toLowerCase(), s=spec[n]
 			let sign=1,o=0; if(val[o]=='-')sign=-1,o++;if(val[o]=='$')o++;
-			tab_get(r,k).push(dyad.parse(lms('%'+fchar(s)),lms(val))),slot++
+			tab_get(r,k).push(s=='?'?lms(val):dyad.parse(lms('%'+fchar(s)),lms(val))),slot++
 		};n++
 		if(i>=text.length||text[i]=='\n'){
-			while(n<spec.length){const u=spec[n++];if(u!='_'&&slot<slots)tab_get(r,tab_cols(r)[slot++]).push('sluvroq'.indexOf(u)>=0?lms(''):NONE);}
-			if(text[i]=='\n'&&i==text.length-1)break;i++,n=0,slot=0
+			while(n<spec.length){const u=spec[n++];if(u!='_'&&slot<slots)tab_get(r,tab_cols(r)[slot++]).push('sluvroq?'.indexOf(u)>=0?lms(''):NONE);}
+			if(text[i]=='\n'&&i==text.length-1)break;i++,n=0,slot=0,rows++
 		}else{while(match(' '));match(d)}
-	};return r
+	};return infer()
 }
 n_writexml=([x,fmt])=>{
 	fmt=fmt?lb(fmt):0
@@ -753,7 +791,7 @@ n_writexml=([x,fmt])=>{
 		return c.length?`${r}${c.map(x=>(' '.repeat(fmt?tab+2:0))+rec(x,tab+2)).join('')}${' '.repeat(fmt?tab:0)}</${t}>${fmt?'\n':''}`:r
 	};return lms(rec(x,0))
 }
-n_readxml=([x])=>{
+n_readxml=([x,p])=>{
 	let i=0,t=ls(x)
 	const xm=x=>t[i]==x?(i++,1):0
 	const xc=_=>{while(t[i]&&t[i]!='>')i++;i++}
@@ -775,7 +813,11 @@ n_readxml=([x])=>{
 			if(xm('/')){xc()}else{if(t[i])i++;dset(tag,lms('children'),rec(n))}
 		}return lml(r)
 	}
-	return rec('')
+	const r=rec('');if(!p||!count(p))return r
+	const seg=ls(p).toLowerCase().split('/'),o=[],walk=(x,d)=>x.v.forEach(v=>{
+		if(!lid(v))return;const n=ls(dget(v,lms('tag')));if(seg[d]!='*'&&seg[d]!=n)return
+		if(d+1==seg.length){o.push(v)}else{walk(dget(v,lms('children')),d+1)}
+	});walk(r,0);return lml(o)
 }
 n_random=z=>{
 	const randint=x=>{let y=seed;y^=(y<<13),y^=(y>>>17),(y^=(y<<15));return mod(seed=y,x);} // xorshift32
@@ -789,7 +831,7 @@ n_random=z=>{
 let frame_count=0
 interface_system=lmi((self,i,x)=>{
 	if(!i)return NONE
-	if(x){if(lis(i)&&i.v=='seed'){seed=0|ln(x);return x}}
+	if(x){if(lis(i)&&i.v=='seed'){seed=0|ln(x);return x};if(lis(i)&&i.v=='workspace'){allocs=0;return x}}
 	if(lis(i)&&i.v=='version'   )return lms(VERSION)
 	if(lis(i)&&i.v=='platform'  )return lms('web')
 	if(lis(i)&&i.v=='seed'      )return lmn(seed)
@@ -2817,6 +2859,7 @@ primitives=(env,deck)=>{
 	env.local('sleep'     ,lmnat(n_sleep   ))
 	env.local('eval'      ,lmnat(n_eval    ))
 	env.local('random'    ,lmnat(n_random  ))
+	env.local('memo'      ,lmnat(n_memo    ))
 	env.local('array'     ,lmnat(n_array   ))
 	env.local('image'     ,lmnat(n_image   ))
 	env.local('sound'     ,lmnat(n_sound   ))
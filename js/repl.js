@@ -34,6 +34,7 @@ env.local('dir',lmnat(([x])=>{
 	});return r
 }))
 env.local('random',lmnat(n_random))
+env.local('memo',lmnat(n_memo))
 env.local('array',lmnat(n_array))
 env.local('image',lmnat(n_image))
 env.local('sound',lmnat(n_sound))
@@ -0,0 +1,55 @@
+#!/usr/bin/env bash
+# performance benchmarks for lil: run each script in tests/bench/
+# several times, reporting the median wall time along with the
+# bytecode ops, allocations and garbage collections of that run.
+# the scripts share the helpers in tests/bench/lib/bench.lil, and some
+# start processes of c/build/lilt, so run this from the root of the
+# repository (make bench does).
+#
+# usage: bench.sh INTERPRETER [RUNS] [SAVE] [BASELINE]
+# - RUNS:     how many times to run each script (default 5).
+# - SAVE:     if given, write the results to this file.
+# - BASELINE: if given, compare median times against a file written by SAVE.
+
+INTERPRETER=$1
+RUNS=${2:-5}
+SAVE=$3
+BASELINE=$4
+echo "running benchmarks against ${INTERPRETER}, ${RUNS} runs each..."
+
+results=$(mktemp)
+printf "%-16s %9s %12s %12s %6s\n" "name" "ms" "ops" "allocs" "gcs"
+for filename in tests/bench/*.lil; do
+	name=$(basename ${filename%.*})
+	runs=$(mktemp)
+	for ((z=0; z<RUNS; z++)); do
+		# the last line on stderr is "ms ops allocs gcs", as measured around import[]:
+		$INTERPRETER -e "w:sys.workspace t:sys.ms r:import[\"${filename}\"] v:sys.workspace
+			if r~0 error[\"unable to run ${filename}\"] exit[1] end
+			error[\"%i %i %i %i\" format (sys.ms-t),(v.ops-w.ops),(v.allocs-w.allocs),(v.gcs-w.gcs)]" \
+			2>&1 >/dev/null | tail -n 1 >> $runs
+		if [ ${PIPESTATUS[0]} != 0 ]; then
+			echo "error running benchmark ${filename}:"
+			cat $runs
+			rm -f $runs $results
+			exit 1
+		fi
+	done
+	line=$(sort -n $runs | sed -n "$(( (RUNS+1)/2 ))p")
+	rm -f $runs
+	echo "$name $line" >> $results
+	read ms ops allocs gcs <<< "$line"
+	printf "%-16s %9s %12s %12s %6s" "$name" "$ms" "$ops" "$allocs" "$gcs"
+	if [ -n "$BASELINE" ] && [ -f "$BASELINE" ]; then
+		base=$(awk -v n="$name" '$1==n{print $2}' "$BASELINE")
+		if [ -n "$base" ]; then
+			awk -v a="$ms" -v b="$base" 'BEGIN{printf "   %6.2fx baseline (%s ms)", (b>0?a/b:1), b}'
+		fi
+	fi
+	printf "\n"
+done
+if [ -n "$SAVE" ]; then
+	cp $results "$SAVE"
+	echo "results saved to ${SAVE}."
+fi
+rm -f $results
@@ -0,0 +1,40 @@
+// stress test for incremental garbage collection: run every test with a collection always under way, advanced by a few
+// hundred values every 100 ops, and check that each run matches a run without, and that whenever marking finishes, no
+// marked value refers to an unmarked one (which means a store into an existing value bypassed lv_shade()).
+// usage: gc
+
+#define main lilt_main
+#include "../c/lilt.c"
+#undef main
+
+long missed=0;
+void unmarked(lv*x){if(x<interned||x>=interned+1024)missed++;} // interned values are never freed, so needn't be marked
+void verify(void){
+	mark.visit=unmarked;lv_mark_roots();for(int z=0;z<gc.size;z++)if(gc.heap[z]&&gc.heap[z]->g==gc.g)lv_scan(gc.heap[z]);
+	mark.visit=NULL;lv_drain(0);
+}
+void step(void){
+	if(gc.sweeping){lv_sweep(lv_clock());return;}if(!gc.marking)lv_mark_begin();
+	if(lv_drain(lv_clock()))lv_mark_end(),verify();
+}
+char* run_test(char*path,int stepped){
+	char*out=NULL;size_t n=0;FILE*o=open_memstream(&out,&n);
+	char*argv[]={"lilt",path,NULL};run_hook=stepped?step:NULL;lilt_job(2,argv,o,o);run_hook=NULL;fclose(o);return out;
+}
+int check(char*path){
+	missed=0;char*a=run_test(path,0),*b=run_test(path,1);int ok=!strcmp(a,b)&&!missed;
+	if(strcmp(a,b))fprintf(stderr,"output doesn't match for %s:\n%s\n----\n%s",path,a,b);
+	if(missed)fprintf(stderr,"%s: %ld reachable values were left unmarked.\n",path,missed);
+	free(a),free(b);return ok;
+}
+int main(void){
+	char*extra[]={"tests/dom/arrays.lil","tests/dom/images.lil","tests/dom/domtests.lil","tests/dom/test_roundtrip.lil",NULL};
+	DIR*dir=opendir("tests");if(!dir){fprintf(stderr,"run from the root of the repository.\n");return 1;}
+	int count=0,fails=0;struct dirent*find;while((find=readdir(dir))){
+		if(!has_suffix(find->d_name,".lil"))continue;
+		char path[4096];snprintf(path,sizeof(path),"tests/%s",find->d_name);fails+=!check(path),count++;
+	}closedir(dir);
+	for(int z=0;extra[z];z++)fails+=!check(extra[z]),count++;
+	if(fails){printf("%d of %d tests failed under incremental collection.\n",fails,count);return 1;}
+	printf("all incremental collection tests passed.\n");return 0;
+}
@@ -0,0 +1,26 @@
+// round trip test for number formatting and parsing: every value printed by wnum() must be read back by the lil
+// number parsers exactly as strtod() reads it, and values with up to 6 decimal places must come back unchanged.
+// usage: numbers [RANDOM]
+
+#define main lilt_main
+#include "../c/lilt.c"
+#undef main
+
+long checked=0,fails=0;str s;
+void check(double x,int exact){
+	s.c=0;wnum(&s,x);str_term(&s);double want=strtod(s.sv,NULL),a=rnum(s.sv,s.c-1),b=pjson_num(s.sv,s.c-1);
+	int l=0;double c=(s.sv[0]=='-'?-1:1)*rnum_len(s.sv+(s.sv[0]=='-'),s.c-1,&l); // as the tokenizer reads a literal
+	if(a!=want||b!=want||c!=want||(exact&&want!=x)){if(fails++<10)printf("%.17g printed as %s, read as %.17g %.17g %.17g\n",x,s.sv,a,b,c);}
+	checked++;
+}
+int main(int argc,char**argv){
+	long n=argc>1?atol(argv[1]):1000000;s=str_new();
+	for(long k=-2000000;k<=2000000;k++)check(k/1000.0,1);             // every value to 3 places in +/-2000
+	for(long k=-10000000;k<=10000000;k+=7)check(k/1000000.0,1);       // a stride of values to 6 places in +/-10
+	for(long k=0;k<n;k++){                                          // assorted magnitudes, whole and fractional
+		unsigned long long r=((unsigned long long)rand()<<31)^rand();double m=r%1000000000000ull;
+		check(m/1000000.0,1),check(-m/100.0,1),check(m,1),check(ldexp((double)r,-(int)(k%60)),0);
+	}
+	if(fails){printf("%ld of %ld numbers failed to round trip.\n",fails,checked);return 1;}
+	printf("all %ld numbers round trip.\n",checked);return 0;
+}
@@ -0,0 +1,47 @@
+// stress test for reentrant interpreters: run every test in tests/ on several threads at once,
+// each job with a heap of its own, and check that every run reproduces the reference output.
+// usage: threads [THREADS] [ROUNDS]
+
+#define main lilt_main
+#include "../c/lilt.c"
+#undef main
+
+typedef struct{char*path,*ref;int err;}test_case;
+test_case*tests=NULL;int test_count=0,rounds=4;
+
+char* slurp(char*path){
+	FILE*f=fopen(path,"rb");if(!f)return NULL;fseek(f,0,SEEK_END);long n=ftell(f);fseek(f,0,SEEK_SET);
+	char*r=calloc(n+1,1);if(fread(r,1,n,f)!=(size_t)n){free(r),r=NULL;}fclose(f);return r;
+}
+int same(char*a,char*b){ // ignoring carriage returns, like diff --strip-trailing-cr
+	while(1){while(*a=='\r')a++;while(*b=='\r')b++;if(*a!=*b)return 0;if(!*a)return 1;a++,b++;}
+}
+void* worker(void*arg){
+	long id=(long)arg,fails=0;
+	for(int r=0;r<rounds;r++)for(int z=0;z<test_count;z++){
+		test_case*t=&tests[(z+id*7)%test_count]; // stagger the threads, so that different tests overlap
+		char*out=NULL,*err=NULL;size_t on=0,en=0;FILE*o=open_memstream(&out,&on),*e=open_memstream(&err,&en);
+		char*argv[]={"lilt",t->path,t->err?"temp.ch8":NULL};lilt_job(t->err?3:2,argv,o,e);fclose(o),fclose(e);
+		int ok=t->err?same(err,t->ref): !en&&same(out,t->ref);
+		if(!ok){fprintf(stderr,"thread %ld: output doesn't match for %s:\n%s%s",id,t->path,out,err);fails++;}
+		free(out),free(err);
+	}return (void*)fails;
+}
+int main(int argc,char**argv){
+	int threads=argc>1?atoi(argv[1]):8;if(argc>2)rounds=atoi(argv[2]);
+	DIR*dir=opendir("tests");if(!dir){fprintf(stderr,"run from the root of the repository.\n");return 1;}
+	struct dirent*find;while((find=readdir(dir))){
+		if(!has_suffix(find->d_name,".lil"))continue;
+		char path[4096],ref[4096];snprintf(path,sizeof(path),"tests/%s",find->d_name);
+		int n=strlen(path)-4,err=0;snprintf(ref,sizeof(ref),"%.*s.out",n,path);char*text=slurp(ref);
+		if(!text){snprintf(ref,sizeof(ref),"%.*s.err",n,path);text=slurp(ref),err=1;}
+		if(!text)continue;tests=realloc(tests,(test_count+1)*sizeof(test_case));
+		tests[test_count++]=(test_case){strdup(path),text,err};
+	}closedir(dir);
+	printf("running %d tests %d times over %d threads...\n",test_count,rounds,threads);
+	pthread_t*t=calloc(threads,sizeof(pthread_t));long fails=0;
+	for(long z=0;z<threads;z++)pthread_create(&t[z],NULL,worker,(void*)z);
+	for(int z=0;z<threads;z++){void*r;pthread_join(t[z],&r);fails+=(long)r;}
+	free(t);if(fails){printf("%ld threaded test runs failed.\n",fails);return 1;}
+	printf("all threaded tests passed.\n");return 0;
+}